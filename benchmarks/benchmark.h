@@ -0,0 +1,45 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_BENCHMARK_H_6F0B3C2A9E5D4B7A8C1D2E3F4A5B6C7D
+#define FS_BENCHMARK_H_6F0B3C2A9E5D4B7A8C1D2E3F4A5B6C7D
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Sink for benchmark results so the optimizer can't drop the measured work
+extern volatile uint64_t benchmarkSink;
+
+// Runs callback iterations times and prints the mean time per call
+template <typename Callback>
+void runBenchmark(const char* name, uint64_t iterations, Callback callback)
+{
+	uint64_t result = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t i = 0; i < iterations; ++i) {
+		result += callback(i);
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	benchmarkSink = benchmarkSink + result;
+
+	std::printf("%-48s %10.1f ns/op\n", name, static_cast<double>(elapsed) / iterations);
+}
+
+#endif
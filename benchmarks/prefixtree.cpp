@@ -0,0 +1,230 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/prefixtree.h"
+
+#include "benchmark.h"
+
+volatile uint64_t benchmarkSink = 0;
+
+namespace {
+
+struct TalkAction {
+	std::string words;
+	std::string separator = " ";
+};
+
+struct InstantSpell {
+	std::string words;
+};
+
+bool startsWithNoCase(const std::string& text, const std::string& prefix)
+{
+	if (text.length() < prefix.length()) {
+		return false;
+	}
+
+	for (size_t i = 0; i < prefix.length(); ++i) {
+		if (std::tolower(static_cast<unsigned char>(text[i])) != std::tolower(static_cast<unsigned char>(prefix[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool getParam(const std::string& words, size_t length, const std::string& separator, std::string& param)
+{
+	param.clear();
+	if (words.length() == length) {
+		return true;
+	}
+
+	param = words.substr(length);
+	if (param.front() != ' ') {
+		return false;
+	}
+	param.erase(0, param.find_first_not_of(' '));
+
+	if (separator != " " && !param.empty()) {
+		if (param != separator) {
+			return false;
+		}
+		param.erase(param.begin());
+	}
+	return true;
+}
+
+// TalkActions::playerSaySpell and Spells::getInstantSpell before user-032:
+// every chat line is compared against every registered word.
+const TalkAction* findTalkActionBefore(const std::map<std::string, TalkAction>& talkActions, const std::string& words)
+{
+	std::string param;
+	for (const auto& it : talkActions) {
+		if (startsWithNoCase(words, it.first) && getParam(words, it.first.length(), it.second.separator, param)) {
+			return &it.second;
+		}
+	}
+	return nullptr;
+}
+
+const InstantSpell* findSpellBefore(const std::map<std::string, InstantSpell>& instants, const std::string& words)
+{
+	const InstantSpell* result = nullptr;
+	for (const auto& it : instants) {
+		const std::string& spellWords = it.second.words;
+		if (startsWithNoCase(words, spellWords) && (!result || spellWords.length() > result->words.length())) {
+			result = &it.second;
+			if (words.length() == spellWords.length()) {
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+// the same lookups through the prefix tree, as they are done now
+const TalkAction* findTalkActionAfter(const PrefixTree<const TalkAction>& tree, const std::string& words)
+{
+	const TalkAction* match = nullptr;
+	std::string param;
+	tree.forEachPrefix(words, [&](size_t length, const TalkAction* talkAction) -> bool {
+		if (match && match->words < talkAction->words) {
+			return false;
+		}
+
+		if (getParam(words, length, talkAction->separator, param)) {
+			match = talkAction;
+		}
+		return false;
+	});
+	return match;
+}
+
+const InstantSpell* findSpellAfter(const PrefixTree<const InstantSpell>& tree, const std::string& words)
+{
+	return tree.findLongestPrefix(words);
+}
+
+// words="..." of every entry in a talkactions.xml or spells.xml
+std::vector<std::string> readWords(const char* fileName, const std::string& tag)
+{
+	std::vector<std::string> words;
+	std::ifstream file(fileName);
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.find("<" + tag) == std::string::npos) {
+			continue;
+		}
+
+		size_t start = line.find("words=\"");
+		if (start != std::string::npos) {
+			start += 7;
+			words.push_back(line.substr(start, line.find('"', start) - start));
+		}
+	}
+	return words;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	// run from the server directory, or pass the data directory
+	const std::string dataDirectory = argc > 1 ? argv[1] : "data";
+	std::vector<std::string> talkWords = readWords((dataDirectory + "/talkactions/talkactions.xml").c_str(), "talkaction");
+	std::vector<std::string> spellWords = readWords((dataDirectory + "/spells/spells.xml").c_str(), "instant");
+	if (talkWords.empty() || spellWords.empty()) {
+		std::printf("no talkactions or spells found in %s\n", dataDirectory.c_str());
+		return 1;
+	}
+
+	std::map<std::string, TalkAction> talkActions;
+	for (const std::string& words : talkWords) {
+		talkActions[words].words = words;
+	}
+	std::map<std::string, InstantSpell> instants;
+	for (const std::string& words : spellWords) {
+		instants[words].words = words;
+	}
+
+	PrefixTree<const TalkAction> talkActionTree;
+	for (const auto& it : talkActions) {
+		talkActionTree.insert(it.first, &it.second);
+	}
+	PrefixTree<const InstantSpell> instantTree;
+	for (const auto& it : instants) {
+		instantTree.insert(it.first, &it.second);
+	}
+
+	// There is no recorded chat log in the tree, so the replay is a
+	// synthetic one: mostly plain chat, then spells (some with a target
+	// name) and commands.
+	static const char* chat[] = {"hi", "hello", "trade", "yes", "no", "bye", "anyone selling a crossbow?", "lol", "where is the boat",
+		"exp party at the dragons?", "omg", "need help with a quest", "thanks", "brb", "ok"};
+
+	std::mt19937 generator(32);
+	std::vector<std::string> lines;
+	for (size_t i = 0; i < 65536; ++i) {
+		uint32_t kind = generator() % 100;
+		if (kind < 60) {
+			lines.emplace_back(chat[generator() % (sizeof(chat) / sizeof(chat[0]))]);
+		} else if (kind < 90) {
+			std::string line = spellWords[generator() % spellWords.size()];
+			if (line.find("sio") != std::string::npos) {
+				line += " \"Knight";
+			}
+			lines.push_back(line);
+		} else {
+			lines.push_back(talkWords[generator() % talkWords.size()] + " Knight");
+		}
+	}
+
+	for (const std::string& line : lines) {
+		if (findTalkActionBefore(talkActions, line) != findTalkActionAfter(talkActionTree, line) ||
+				findSpellBefore(instants, line) != findSpellAfter(instantTree, line)) {
+			std::printf("lookup mismatch for \"%s\"\n", line.c_str());
+			return 1;
+		}
+	}
+
+	std::printf("%zu talkactions, %zu instant spells, %zu chat lines\n", talkActions.size(), instants.size(), lines.size());
+	runBenchmark("  linear scan per line", 2000000, [&](uint64_t i) {
+		const std::string& line = lines[i & 65535];
+		if (findTalkActionBefore(talkActions, line)) {
+			return 1;
+		}
+		return findSpellBefore(instants, line) ? 2 : 0;
+	});
+	runBenchmark("  prefix tree per line", 2000000, [&](uint64_t i) {
+		const std::string& line = lines[i & 65535];
+		if (findTalkActionAfter(talkActionTree, line)) {
+			return 1;
+		}
+		return findSpellAfter(instantTree, line) ? 2 : 0;
+	});
+	return 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <random>
+
+#include "../src/random.h"
+
+#include "benchmark.h"
+
+volatile uint64_t benchmarkSink = 0;
+
+namespace {
+
+// uniform_random and boolean_random before user-049: a std::mt19937 and a
+// distribution object fed new parameters on every call
+std::mt19937 mersenneTwister(0);
+
+int32_t uniformBefore(int32_t minNumber, int32_t maxNumber)
+{
+	static std::uniform_int_distribution<int32_t> uniformRand;
+	return uniformRand(mersenneTwister, std::uniform_int_distribution<int32_t>::param_type(minNumber, maxNumber));
+}
+
+bool booleanBefore(double probability)
+{
+	static std::bernoulli_distribution booleanRand;
+	return booleanRand(mersenneTwister, std::bernoulli_distribution::param_type(probability));
+}
+
+// the same draws as uniform_random and boolean_random make them now
+Xoshiro256 xoshiro(0);
+
+int32_t uniformAfter(int32_t minNumber, int32_t maxNumber)
+{
+	const uint32_t range = static_cast<uint32_t>(maxNumber) - static_cast<uint32_t>(minNumber);
+	return static_cast<int32_t>(static_cast<uint32_t>(minNumber) + xoshiro.bounded(range + 1));
+}
+
+bool booleanAfter(double probability)
+{
+	return xoshiro.canonical() < probability;
+}
+
+uint64_t checksum(uint64_t seed)
+{
+	Xoshiro256 generator(seed);
+	uint64_t sum = 0;
+	for (int i = 0; i < 1000; ++i) {
+		sum = sum * 31 + generator.bounded(100001);
+	}
+	return sum;
+}
+
+}
+
+int main()
+{
+	// a fixed seed gives the same stream on every run and platform, which
+	// is what makes seeded servers and replays reproducible
+	if (checksum(12345) != checksum(12345) || checksum(12345) == checksum(12346)) {
+		std::printf("seeded streams are not reproducible\n");
+		return 1;
+	}
+	std::printf("seed 12345 checksum %llu\n", static_cast<unsigned long long>(checksum(12345)));
+
+	// loot rolls, damage ranges and percent chances
+	runBenchmark("  mt19937 uniform_random(0, 100000)", 50000000, [](uint64_t) {
+		return uniformBefore(0, 100000);
+	});
+	runBenchmark("  xoshiro256 uniform_random(0, 100000)", 50000000, [](uint64_t) {
+		return uniformAfter(0, 100000);
+	});
+	runBenchmark("  mt19937 uniform_random(min, max) varying", 50000000, [](uint64_t i) {
+		return uniformBefore(static_cast<int32_t>(i & 63), static_cast<int32_t>(100 + (i & 1023)));
+	});
+	runBenchmark("  xoshiro256 uniform_random(min, max) varying", 50000000, [](uint64_t i) {
+		return uniformAfter(static_cast<int32_t>(i & 63), static_cast<int32_t>(100 + (i & 1023)));
+	});
+	runBenchmark("  mt19937 boolean_random(0.3)", 50000000, [](uint64_t) {
+		return booleanBefore(0.3) ? 1 : 0;
+	});
+	runBenchmark("  xoshiro256 boolean_random(0.3)", 50000000, [](uint64_t) {
+		return booleanAfter(0.3) ? 1 : 0;
+	});
+	return 0;
+}
@@ -0,0 +1,264 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "serverbenchmark.h"
+
+#include "fileloader.h"
+#include "item.h"
+
+#include <forward_list>
+#include <numeric>
+#include <random>
+
+namespace {
+
+const std::string emptyString;
+
+// ItemAttributes as it was before the inline storage: one list node per
+// attribute, a string allocation per text and a linear search per access
+class ListAttributes
+{
+	public:
+		ListAttributes() = default;
+
+		// non-copyable
+		ListAttributes(const ListAttributes&) = delete;
+		ListAttributes& operator=(const ListAttributes&) = delete;
+
+		int64_t getIntAttr(itemAttrTypes type) const {
+			const Attribute* attr = getExistingAttr(type);
+			return attr ? attr->value.integer : 0;
+		}
+		void setIntAttr(itemAttrTypes type, int64_t value) {
+			getAttr(type, false).value.integer = value;
+		}
+
+		const std::string& getStrAttr(itemAttrTypes type) const {
+			const Attribute* attr = getExistingAttr(type);
+			if (!attr || !attr->value.string) {
+				return emptyString;
+			}
+			return *attr->value.string;
+		}
+		void setStrAttr(itemAttrTypes type, const std::string& value) {
+			Attribute& attr = getAttr(type, true);
+			delete attr.value.string;
+			attr.value.string = new std::string(value);
+		}
+
+	private:
+		struct Attribute {
+			Attribute(itemAttrTypes type, bool isString) : type(type), isString(isString) {
+				value.integer = 0;
+			}
+			~Attribute() {
+				if (isString) {
+					delete value.string;
+				}
+			}
+
+			// non-copyable
+			Attribute(const Attribute&) = delete;
+			Attribute& operator=(const Attribute&) = delete;
+
+			union {
+				int64_t integer;
+				std::string* string;
+			} value;
+			itemAttrTypes type;
+			bool isString;
+		};
+
+		const Attribute* getExistingAttr(itemAttrTypes type) const {
+			if ((attributeBits & type) != 0) {
+				for (const Attribute& attribute : attributes) {
+					if (attribute.type == type) {
+						return &attribute;
+					}
+				}
+			}
+			return nullptr;
+		}
+
+		Attribute& getAttr(itemAttrTypes type, bool isString) {
+			if ((attributeBits & type) != 0) {
+				for (Attribute& attribute : attributes) {
+					if (attribute.type == type) {
+						return attribute;
+					}
+				}
+			}
+
+			attributeBits |= type;
+			attributes.emplace_front(type, isString);
+			return attributes.front();
+		}
+
+		std::forward_list<Attribute> attributes;
+		uint32_t attributeBits = 0;
+};
+
+// house decorations and letters share a few writers and texts
+const std::string writers[] = {"Arthur", "Bubble", "Cip", "Durin"};
+const std::string texts[] = {"Happy birthday!", "Welcome to my house.", "Do not touch.", "Property of the guild."};
+
+// a rune, a decoration with a text and a decaying item, in turns
+template <typename Attributes>
+void fillAttributes(Attributes& attributes, size_t index)
+{
+	switch (index % 3) {
+		case 0:
+			attributes.setIntAttr(ITEM_ATTRIBUTE_CHARGES, 3 + index % 7);
+			attributes.setIntAttr(ITEM_ATTRIBUTE_ACTIONID, 2000 + index % 10);
+			break;
+		case 1:
+			attributes.setIntAttr(ITEM_ATTRIBUTE_ACTIONID, 1000 + index % 100);
+			attributes.setIntAttr(ITEM_ATTRIBUTE_DATE, 1500000000 + index);
+			attributes.setStrAttr(ITEM_ATTRIBUTE_WRITER, writers[index % 4]);
+			attributes.setStrAttr(ITEM_ATTRIBUTE_TEXT, texts[index / 3 % 4]);
+			break;
+		default:
+			attributes.setIntAttr(ITEM_ATTRIBUTE_DURATION, 60000 + index);
+			attributes.setIntAttr(ITEM_ATTRIBUTE_CHARGES, 1 + index % 3);
+			attributes.setStrAttr(ITEM_ATTRIBUTE_DESCRIPTION, texts[index % 4]);
+			break;
+	}
+}
+
+// the reads of moving, looking at and using the item
+template <typename Attributes>
+uint64_t readAttributes(const Attributes& attributes)
+{
+	uint64_t result = attributes.getIntAttr(ITEM_ATTRIBUTE_ACTIONID);
+	result += attributes.getIntAttr(ITEM_ATTRIBUTE_UNIQUEID);
+	result += attributes.getIntAttr(ITEM_ATTRIBUTE_CHARGES);
+	result += attributes.getIntAttr(ITEM_ATTRIBUTE_DURATION);
+	result += attributes.getIntAttr(ITEM_ATTRIBUTE_DATE);
+	result += attributes.getStrAttr(ITEM_ATTRIBUTE_TEXT).size();
+	result += attributes.getStrAttr(ITEM_ATTRIBUTE_WRITER).size();
+	result += attributes.getStrAttr(ITEM_ATTRIBUTE_DESCRIPTION).size();
+	return result;
+}
+
+bool isPlainItem(const ItemType& it)
+{
+	return it.moveable && it.pickupable && !it.stackable && !it.isFluidContainer() && !it.isSplash() && it.decayTo == -1;
+}
+
+}
+
+void benchmarkAttributes(const std::vector<Monster*>&)
+{
+	const uint16_t itemId = findBenchmarkItemId(isPlainItem);
+	if (itemId == 0) {
+		std::cout << "No plain item type to put the attributes on." << std::endl;
+		return;
+	}
+
+	static constexpr size_t itemCount = 4096;
+
+	std::vector<std::unique_ptr<ListAttributes>> lists;
+	std::vector<Item*> items;
+	for (size_t i = 0; i < itemCount; ++i) {
+		lists.emplace_back(new ListAttributes());
+		fillAttributes(*lists.back(), i);
+
+		items.push_back(Item::CreateItem(itemId));
+		fillAttributes(*items.back(), i);
+
+		if (readAttributes(*lists.back()) != readAttributes(*items.back())) {
+			std::cout << "Mismatch between the attribute lists of item " << i << '.' << std::endl;
+			return;
+		}
+	}
+
+	// visit the items in no particular order, like the moves of a server do
+	std::vector<size_t> order(itemCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::shuffle(order.begin(), order.end(), std::mt19937(30));
+
+	std::cout << itemCount << " items of type " << itemId << ':' << std::endl;
+	runBenchmark("Item::CreateItem and delete", itemCount, [&](uint64_t i) {
+		Item* item = Item::CreateItem(itemId);
+		uint64_t result = item->getID() + i;
+		delete item;
+		return result;
+	});
+	runBenchmark("create, set, delete, forward_list", itemCount, [&](uint64_t i) {
+		Item* item = Item::CreateItem(itemId);
+		ListAttributes attributes;
+		fillAttributes(attributes, i);
+		uint64_t result = readAttributes(attributes);
+		delete item;
+		return result;
+	});
+	runBenchmark("create, set, delete, ItemAttributes", itemCount, [&](uint64_t i) {
+		Item* item = Item::CreateItem(itemId);
+		fillAttributes(*item, i);
+		uint64_t result = readAttributes(*item);
+		delete item;
+		return result;
+	});
+
+	runBenchmark("get, forward_list", itemCount * 16, [&](uint64_t i) {
+		return readAttributes(*lists[order[i % itemCount]]);
+	});
+	runBenchmark("get, ItemAttributes", itemCount * 16, [&](uint64_t i) {
+		return readAttributes(*items[order[i % itemCount]]);
+	});
+
+	PropWriteStream propWriteStream;
+	runBenchmark("Item::serializeAttr", itemCount * 4, [&](uint64_t i) {
+		propWriteStream.clear();
+		items[order[i % itemCount]]->serializeAttr(propWriteStream);
+
+		size_t size;
+		propWriteStream.getStream(size);
+		return size;
+	});
+
+	std::vector<std::string> buffers;
+	buffers.reserve(itemCount);
+	for (const Item* item : items) {
+		propWriteStream.clear();
+		item->serializeAttr(propWriteStream);
+
+		size_t size;
+		const char* stream = propWriteStream.getStream(size);
+		buffers.emplace_back(stream, size);
+	}
+
+	runBenchmark("create, Item::unserializeAttr, delete", itemCount, [&](uint64_t i) {
+		const std::string& buffer = buffers[order[i]];
+
+		PropStream propStream;
+		propStream.init(buffer.data(), buffer.size());
+
+		Item* item = Item::CreateItem(itemId);
+		uint64_t result = item->unserializeAttr(propStream) ? readAttributes(*item) : 0;
+		delete item;
+		return result;
+	});
+
+	for (Item* item : items) {
+		delete item;
+	}
+}
@@ -0,0 +1,128 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "serverbenchmark.h"
+
+#include "game.h"
+#include "monster.h"
+
+#include <random>
+
+extern Game g_game;
+
+namespace {
+
+bool isWalkableGround(const ItemType& it)
+{
+	return it.isGroundTile() && it.speed >= 100 && it.floorChange == 0 && !it.blockSolid && !it.blockPathFind && !it.blockProjectile;
+}
+
+bool isBlockingItem(const ItemType& it)
+{
+	return it.blockSolid && it.blockProjectile && !it.moveable && !it.alwaysOnTop && !it.hasHeight && it.floorChange == 0;
+}
+
+bool isLooseItem(const ItemType& it)
+{
+	return it.moveable && it.pickupable && !it.stackable && !it.blockSolid && !it.blockPathFind && !it.alwaysOnTop;
+}
+
+}
+
+uint16_t findBenchmarkItemId(bool (*predicate)(const ItemType& it))
+{
+	for (size_t id = 100, size = Item::items.size(); id < size; ++id) {
+		const ItemType& it = Item::items[id];
+		if (it.id != 0 && it.group == ITEM_GROUP_NONE && it.type == ITEM_TYPE_NONE && predicate(it)) {
+			return it.id;
+		}
+	}
+	return 0;
+}
+
+void createBenchmarkArea(uint32_t seed)
+{
+	const uint16_t groundId = findBenchmarkItemId(isWalkableGround);
+	const uint16_t blockingId = findBenchmarkItemId(isBlockingItem);
+	const uint16_t looseId = findBenchmarkItemId(isLooseItem);
+	if (groundId == 0 || blockingId == 0 || looseId == 0) {
+		std::cout << "[Warning - createBenchmarkArea] Missing item types, the area has no obstacles." << std::endl;
+	}
+
+	std::mt19937 generator(seed);
+	std::uniform_int_distribution<uint32_t> percent(0, 99);
+
+	for (uint16_t y = BENCHMARK_AREA_Y; y < BENCHMARK_AREA_Y + BENCHMARK_AREA_HEIGHT; ++y) {
+		for (uint16_t x = BENCHMARK_AREA_X; x < BENCHMARK_AREA_X + BENCHMARK_AREA_WIDTH; ++x) {
+			const uint32_t roll = percent(generator);
+
+			Tile* tile;
+			Item* item = nullptr;
+			if (roll < 8 && blockingId != 0) {
+				tile = new StaticTile(x, y, BENCHMARK_AREA_Z);
+				item = Item::CreateItem(blockingId);
+			} else {
+				tile = new DynamicTile(x, y, BENCHMARK_AREA_Z);
+				if (roll >= 90 && looseId != 0) {
+					item = Item::CreateItem(looseId);
+				}
+			}
+
+			if (groundId != 0) {
+				tile->internalAddThing(Item::CreateItem(groundId));
+			}
+
+			if (item) {
+				tile->internalAddThing(item);
+			}
+			g_game.map.setTile(x, y, BENCHMARK_AREA_Z, tile);
+		}
+	}
+}
+
+std::vector<Monster*> placeBenchmarkMonsters(MonsterType* mType, size_t count, size_t groupSize, uint32_t seed)
+{
+	std::mt19937 generator(seed);
+
+	// keep the groups a view range off the border so every monster has a full view around it
+	std::uniform_int_distribution<uint16_t> centerX(BENCHMARK_AREA_X + Map::maxViewportX, BENCHMARK_AREA_X + BENCHMARK_AREA_WIDTH - Map::maxViewportX - 1);
+	std::uniform_int_distribution<uint16_t> centerY(BENCHMARK_AREA_Y + Map::maxViewportY, BENCHMARK_AREA_Y + BENCHMARK_AREA_HEIGHT - Map::maxViewportY - 1);
+	std::uniform_int_distribution<int32_t> spread(-3, 3);
+
+	std::vector<Monster*> monsters;
+	monsters.reserve(count);
+
+	Position center;
+	for (size_t i = 0; i < count; ++i) {
+		if (i % groupSize == 0) {
+			center = Position(centerX(generator), centerY(generator), BENCHMARK_AREA_Z);
+		}
+
+		Monster* monster = new Monster(mType);
+		Position pos(center.x + spread(generator), center.y + spread(generator), BENCHMARK_AREA_Z);
+		if (!g_game.placeCreature(monster, pos, true, false)) {
+			delete monster;
+			continue;
+		}
+		monsters.push_back(monster);
+	}
+	return monsters;
+}
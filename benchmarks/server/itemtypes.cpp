@@ -0,0 +1,153 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "serverbenchmark.h"
+
+#include "game.h"
+#include "monster.h"
+
+#include <random>
+
+extern Game g_game;
+
+namespace {
+
+// Item::hasProperty as it was before the hot item type table, every
+// check reads the full ItemType
+bool hasPropertyFullType(const Item& item, ITEMPROPERTY prop)
+{
+	const ItemType& it = Item::items[item.getID()];
+	switch (prop) {
+		case CONST_PROP_BLOCKSOLID: return it.blockSolid;
+		case CONST_PROP_MOVEABLE: return it.moveable && !item.hasAttribute(ITEM_ATTRIBUTE_UNIQUEID);
+		case CONST_PROP_HASHEIGHT: return it.hasHeight;
+		case CONST_PROP_BLOCKPROJECTILE: return it.blockProjectile;
+		case CONST_PROP_BLOCKPATH: return it.blockPathFind;
+		case CONST_PROP_ISVERTICAL: return it.isVertical;
+		case CONST_PROP_ISHORIZONTAL: return it.isHorizontal;
+		case CONST_PROP_IMMOVABLEBLOCKSOLID: return it.blockSolid && (!it.moveable || item.hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
+		case CONST_PROP_IMMOVABLEBLOCKPATH: return it.blockPathFind && (!it.moveable || item.hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
+		case CONST_PROP_IMMOVABLENOFIELDBLOCKPATH: return !it.isMagicField() && it.blockPathFind && (!it.moveable || item.hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
+		case CONST_PROP_NOFIELDBLOCKPATH: return !it.isMagicField() && it.blockPathFind;
+		case CONST_PROP_SUPPORTHANGABLE: return it.isHorizontal || it.isVertical;
+		default: return false;
+	}
+}
+
+// The item checks of a step onto the tile: blocking items, path blockers
+// and the ground speed
+template <typename HasProperty, typename GroundSpeed>
+uint64_t checkTile(const Tile& tile, HasProperty hasProperty, GroundSpeed groundSpeed)
+{
+	uint64_t result = 0;
+	if (const Item* ground = tile.getGround()) {
+		result += groundSpeed(*ground);
+		result += hasProperty(*ground, CONST_PROP_IMMOVABLEBLOCKSOLID);
+	}
+
+	if (const TileItemVector* items = tile.getItemList()) {
+		for (const Item* item : *items) {
+			result += hasProperty(*item, CONST_PROP_IMMOVABLEBLOCKSOLID);
+			result += hasProperty(*item, CONST_PROP_NOFIELDBLOCKPATH) << 1;
+			result += hasProperty(*item, CONST_PROP_BLOCKPROJECTILE) << 2;
+		}
+	}
+	return result;
+}
+
+}
+
+void benchmarkItemTypes(const std::vector<Monster*>& monsters)
+{
+	std::mt19937 generator(26);
+
+	// the tiles around the monsters, in the order they would step on them
+	std::vector<const Tile*> tiles;
+	for (const Monster* monster : monsters) {
+		const Position& pos = monster->getPosition();
+		for (int32_t dy = -Map::maxClientViewportY; dy <= Map::maxClientViewportY; ++dy) {
+			for (int32_t dx = -Map::maxClientViewportX; dx <= Map::maxClientViewportX; ++dx) {
+				if (const Tile* tile = g_game.map.getTile(pos.x + dx, pos.y + dy, pos.z)) {
+					tiles.push_back(tile);
+				}
+			}
+		}
+	}
+	std::shuffle(tiles.begin(), tiles.end(), generator);
+
+	if (tiles.empty()) {
+		std::cout << "No tiles around the monsters." << std::endl;
+		return;
+	}
+
+	auto hasPropertyHot = [](const Item& item, ITEMPROPERTY prop) { return item.hasProperty(prop); };
+	auto groundSpeedHot = [](const Item& ground) { return Item::items.getHotType(ground.getID()).speed; };
+	auto groundSpeedFull = [](const Item& ground) { return Item::items[ground.getID()].speed; };
+
+	for (const Tile* tile : tiles) {
+		if (checkTile(*tile, hasPropertyFullType, groundSpeedFull) != checkTile(*tile, hasPropertyHot, groundSpeedHot)) {
+			std::cout << "Mismatch between the item type tables at " << tile->getPosition() << '.' << std::endl;
+			return;
+		}
+	}
+
+	std::cout << tiles.size() << " tiles around " << monsters.size() << " monsters:" << std::endl;
+	runBenchmark("tile item checks, full ItemType", tiles.size(), [&](uint64_t i) {
+		return checkTile(*tiles[i], hasPropertyFullType, groundSpeedFull);
+	});
+	runBenchmark("tile item checks, ItemTypeHot", tiles.size(), [&](uint64_t i) {
+		return checkTile(*tiles[i], hasPropertyHot, groundSpeedHot);
+	});
+
+	if (monsters.empty()) {
+		return;
+	}
+
+	// what Map::canWalkTo asks for the tiles outside the walk cache
+	const uint64_t queryCount = tiles.size();
+	runBenchmark("Tile::queryAdd(FLAG_PATHFINDING)", queryCount, [&](uint64_t i) {
+		const Monster& monster = *monsters[i % monsters.size()];
+		return tiles[i]->queryAdd(0, monster, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR;
+	});
+
+	// chase a spot up to seven tiles away, with the parameters of Creature::getPathSearchParams
+	std::uniform_int_distribution<int32_t> offset(-Map::maxClientViewportY, Map::maxClientViewportY);
+	std::vector<Position> targets;
+	targets.reserve(monsters.size());
+	for (const Monster* monster : monsters) {
+		const Position& pos = monster->getPosition();
+		targets.emplace_back(pos.x + offset(generator), pos.y + offset(generator), pos.z);
+	}
+
+	FindPathParams fpp;
+	fpp.fullPathSearch = true;
+	fpp.clearSight = true;
+	fpp.maxSearchDist = 12;
+	fpp.minTargetDist = 1;
+	fpp.maxTargetDist = 1;
+
+	std::forward_list<Direction> dirList;
+	runBenchmark("Map::getPathMatching", monsters.size() * 4, [&](uint64_t i) {
+		const size_t index = i % monsters.size();
+		dirList.clear();
+		return g_game.map.getPathMatching(*monsters[index], dirList, FrozenPathingConditionCall(targets[index]), fpp);
+	});
+}
@@ -0,0 +1,157 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "serverbenchmark.h"
+
+#include "configmanager.h"
+#include "container.h"
+#include "monsters.h"
+
+extern ConfigManager g_config;
+extern Monsters g_monsters;
+extern LuaEnvironment g_luaEnvironment;
+
+namespace {
+
+// the default onDropLoot before and after MonsterType::createLoot
+const std::string dropLootScript = R"(
+function benchmarkDropLootTables(monsterType, corpse)
+	local monsterLoot = monsterType:getLoot()
+	for i = 1, #monsterLoot do
+		corpse:createLootItem(monsterLoot[i])
+	end
+end
+
+function benchmarkDropLoot(monsterType, corpse)
+	monsterType:createLoot(corpse)
+end
+)";
+
+struct Kill {
+	MonsterType* mType;
+	uint16_t corpseId;
+};
+
+// every monster type of monsters.xml with loot and a corpse to put it in
+std::vector<Kill> getKills()
+{
+	std::vector<Kill> kills;
+
+	pugi::xml_document doc;
+	if (!doc.load_file("data/monster/monsters.xml")) {
+		return kills;
+	}
+
+	for (auto monsterNode : doc.child("monsters").children()) {
+		MonsterType* mType = g_monsters.getMonsterType(monsterNode.attribute("name").as_string());
+		if (!mType || mType->info.lootItems.empty()) {
+			continue;
+		}
+
+		const uint16_t corpseId = mType->info.lookcorpse;
+		if (corpseId == 0 || !Item::items[corpseId].isContainer()) {
+			continue;
+		}
+		kills.push_back({mType, corpseId});
+	}
+	return kills;
+}
+
+bool callDropLoot(lua_State* L, const char* function, MonsterType* mType, Container* corpse)
+{
+	if (!LuaScriptInterface::reserveScriptEnv()) {
+		return false;
+	}
+
+	lua_getglobal(L, function);
+	LuaScriptInterface::pushUserdata<MonsterType>(L, mType);
+	LuaScriptInterface::setMetatable(L, -1, "MonsterType");
+	LuaScriptInterface::pushUserdata<Container>(L, corpse);
+	LuaScriptInterface::setMetatable(L, -1, "Container");
+
+	bool success = LuaScriptInterface::protectedCall(L, 2, 0) == 0;
+	if (!success) {
+		std::cout << "[Error - callDropLoot] " << LuaScriptInterface::popString(L) << std::endl;
+	}
+
+	LuaScriptInterface::resetScriptEnv();
+	return success;
+}
+
+// one kill: the corpse, its loot and the corpse decaying away again
+template <typename DropLoot>
+uint64_t killMonster(const Kill& kill, uint64_t& droppedItems, DropLoot dropLoot)
+{
+	Item* item = Item::CreateItem(kill.corpseId);
+	Container* corpse = item->getContainer();
+	dropLoot(kill.mType, corpse);
+
+	const uint64_t dropped = corpse->getItemHoldingCount();
+	droppedItems += dropped;
+	delete item;
+	return dropped;
+}
+
+}
+
+void benchmarkLoot(const std::vector<Monster*>&)
+{
+	const std::vector<Kill> kills = getKills();
+	if (kills.empty()) {
+		std::cout << "No monster types with loot." << std::endl;
+		return;
+	}
+
+	lua_State* L = g_luaEnvironment.getLuaState();
+	if (luaL_loadbuffer(L, dropLootScript.data(), dropLootScript.size(), "=loot benchmark") != 0 || LuaScriptInterface::protectedCall(L, 0, 0) != 0) {
+		std::cout << "> ERROR: " << LuaScriptInterface::popString(L) << std::endl;
+		return;
+	}
+
+	// a kill storm going through every monster type in turn
+	const uint64_t killCount = std::max<uint64_t>(kills.size() * 16, 16384);
+	uint64_t tableItems = 0, luaItems = 0, nativeItems = 0;
+
+	std::cout << kills.size() << " monster types, " << killCount << " kills, rate " << g_config.getNumber(ConfigManager::RATE_LOOT) << ':' << std::endl;
+	runBenchmark("create and delete the corpse", killCount, [&](uint64_t i) {
+		uint64_t droppedItems = 0;
+		return killMonster(kills[i % kills.size()], droppedItems, [](MonsterType*, Container*) {});
+	});
+	runBenchmark("onDropLoot, getLoot and createLootItem", killCount, [&](uint64_t i) {
+		return killMonster(kills[i % kills.size()], tableItems, [L](MonsterType* mType, Container* corpse) {
+			callDropLoot(L, "benchmarkDropLootTables", mType, corpse);
+		});
+	});
+	runBenchmark("onDropLoot, MonsterType:createLoot", killCount, [&](uint64_t i) {
+		return killMonster(kills[i % kills.size()], luaItems, [L](MonsterType* mType, Container* corpse) {
+			callDropLoot(L, "benchmarkDropLoot", mType, corpse);
+		});
+	});
+	runBenchmark("MonsterType::createLoot", killCount, [&](uint64_t i) {
+		return killMonster(kills[i % kills.size()], nativeItems, [](MonsterType* mType, Container* corpse) {
+			mType->createLoot(corpse);
+		});
+	});
+
+	std::cout << "Items per kill: " << static_cast<double>(tableItems) / killCount << " with Lua tables, "
+	          << static_cast<double>(luaItems) / killCount << " with MonsterType:createLoot, "
+	          << static_cast<double>(nativeItems) / killCount << " with MonsterType::createLoot" << std::endl;
+}
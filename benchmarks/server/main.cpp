@@ -0,0 +1,147 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "serverbenchmark.h"
+
+#include "configmanager.h"
+#include "databasetasks.h"
+#include "game.h"
+#include "monster.h"
+#include "monsters.h"
+#include "rsa.h"
+#include "scheduler.h"
+#include "script.h"
+#include "scriptmanager.h"
+#include "vocation.h"
+#include "watchdog.h"
+
+// the globals otserv.cpp defines for the server
+DatabaseTasks g_databaseTasks;
+Dispatcher g_dispatcher;
+Scheduler g_scheduler;
+Watchdog g_watchdog;
+
+Game g_game;
+ConfigManager g_config;
+Monsters g_monsters;
+Vocations g_vocations;
+extern Scripts* g_scripts;
+RSA g_RSA;
+
+volatile uint64_t benchmarkSink = 0;
+
+namespace {
+
+struct BenchmarkCase {
+	const char* name;
+	void (*run)(const std::vector<Monster*>& monsters);
+};
+
+const BenchmarkCase benchmarkCases[] = {
+	{"itemtypes", benchmarkItemTypes},
+	{"sight", benchmarkSight},
+	{"attributes", benchmarkAttributes},
+	{"spectators", benchmarkSpectators},
+	{"loot", benchmarkLoot},
+};
+
+// the data mainLoader loads, without the database, the map and the network
+bool loadServerData()
+{
+	if (!g_config.load()) {
+		std::cout << "> ERROR: Unable to load config.lua, run the benchmark from the server directory." << std::endl;
+		return false;
+	}
+
+	if (!g_vocations.loadFromXml()) {
+		std::cout << "> ERROR: Unable to load vocations!" << std::endl;
+		return false;
+	}
+
+	if (!Item::items.loadFromOtb("data/items/items.otb") || !Item::items.loadFromXml()) {
+		std::cout << "> ERROR: Unable to load items!" << std::endl;
+		return false;
+	}
+
+	if (!ScriptingManager::getInstance().loadScriptSystems() || !g_scripts->loadScripts("scripts", false, false)) {
+		std::cout << "> ERROR: Unable to load the script systems!" << std::endl;
+		return false;
+	}
+
+	if (!g_monsters.loadFromXml() || !g_scripts->loadScripts("monster", false, false)) {
+		std::cout << "> ERROR: Unable to load monsters!" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+}
+
+// Benchmarks of the server code on a synthetic hunting ground, run from the
+// server directory:
+// server_benchmark [--monster name] [--monsters count] [--group size] [case...]
+int main(int argc, char* argv[])
+{
+	std::string monsterName = "Orc";
+	size_t monsterCount = 2000;
+	size_t groupSize = 6;
+	std::vector<std::string> caseNames;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--monster" && i + 1 < argc) {
+			monsterName = argv[++i];
+		} else if (arg == "--monsters" && i + 1 < argc) {
+			monsterCount = std::max<size_t>(std::stoul(argv[++i]), 1);
+		} else if (arg == "--group" && i + 1 < argc) {
+			groupSize = std::max<size_t>(std::stoul(argv[++i]), 1);
+		} else {
+			caseNames.push_back(arg);
+		}
+	}
+
+	if (!loadServerData()) {
+		return 1;
+	}
+
+	// the same map, monsters and rolls on every run
+	setRandomSeed(1);
+
+	MonsterType* mType = g_monsters.getMonsterType(monsterName);
+	if (!mType) {
+		std::cout << "> ERROR: Unknown monster " << monsterName << '.' << std::endl;
+		return 1;
+	}
+
+	createBenchmarkArea(1);
+	std::vector<Monster*> monsters = placeBenchmarkMonsters(mType, monsterCount, groupSize, 1);
+	std::cout << ">> " << monsters.size() << " monsters of type " << mType->name << " in groups of " << groupSize << std::endl;
+
+	for (const BenchmarkCase& benchmarkCase : benchmarkCases) {
+		if (!caseNames.empty() && std::find(caseNames.begin(), caseNames.end(), benchmarkCase.name) == caseNames.end()) {
+			continue;
+		}
+
+		std::cout << std::endl << "== " << benchmarkCase.name << " ==" << std::endl;
+		benchmarkCase.run(monsters);
+	}
+	return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_SERVERBENCHMARK_H_5E0F5EC0AB1047428CD06DA7B2F789BC
+#define FS_SERVERBENCHMARK_H_5E0F5EC0AB1047428CD06DA7B2F789BC
+
+#include "position.h"
+
+#include "../benchmark.h"
+
+class ItemType;
+class Monster;
+class MonsterType;
+
+// The synthetic hunting ground every map benchmark runs on, on floor 7
+static constexpr uint16_t BENCHMARK_AREA_X = 1000;
+static constexpr uint16_t BENCHMARK_AREA_Y = 1000;
+static constexpr uint16_t BENCHMARK_AREA_WIDTH = 256;
+static constexpr uint16_t BENCHMARK_AREA_HEIGHT = 256;
+static constexpr uint8_t BENCHMARK_AREA_Z = 7;
+
+// The first plain item type (no container, door, field...) matching the predicate, 0 if none does
+uint16_t findBenchmarkItemId(bool (*predicate)(const ItemType& it));
+
+/**
+  * Covers the benchmark area with walkable ground. Some tiles get an item
+  * that blocks movement and projectiles (stones, trees) and some others an
+  * item lying on the ground, the same tiles for the same seed.
+  */
+void createBenchmarkArea(uint32_t seed);
+
+/**
+  * Places count monsters of the type in the benchmark area in groups of
+  * groupSize, each group spread around its own center like a spawn.
+  * \returns The monsters that found a free tile
+  */
+std::vector<Monster*> placeBenchmarkMonsters(MonsterType* mType, size_t count, size_t groupSize, uint32_t seed);
+
+// Benchmark cases, they get the monsters placed in the benchmark area
+void benchmarkItemTypes(const std::vector<Monster*>& monsters);
+void benchmarkSight(const std::vector<Monster*>& monsters);
+void benchmarkAttributes(const std::vector<Monster*>& monsters);
+void benchmarkSpectators(const std::vector<Monster*>& monsters);
+void benchmarkLoot(const std::vector<Monster*>& monsters);
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "serverbenchmark.h"
+
+#include "game.h"
+#include "monster.h"
+
+extern Game g_game;
+
+namespace {
+
+// Map::checkSightLine as it was before the floor masks, one getTile and
+// one item scan per step of the line
+bool checkSightLineTiles(const Map& map, const Position& fromPos, const Position& toPos)
+{
+	if (fromPos == toPos) {
+		return true;
+	}
+
+	Position start(fromPos.z > toPos.z ? toPos : fromPos);
+	Position destination(fromPos.z > toPos.z ? fromPos : toPos);
+
+	const int8_t mx = start.x < destination.x ? 1 : start.x == destination.x ? 0 : -1;
+	const int8_t my = start.y < destination.y ? 1 : start.y == destination.y ? 0 : -1;
+
+	int32_t A = Position::getOffsetY(destination, start);
+	int32_t B = Position::getOffsetX(start, destination);
+	int32_t C = -(A * destination.x + B * destination.y);
+
+	while (start.x != destination.x || start.y != destination.y) {
+		int32_t move_hor = std::abs(A * (start.x + mx) + B * (start.y) + C);
+		int32_t move_ver = std::abs(A * (start.x) + B * (start.y + my) + C);
+		int32_t move_cross = std::abs(A * (start.x + mx) + B * (start.y + my) + C);
+
+		if (start.y != destination.y && (start.x == destination.x || move_hor > move_ver || move_hor > move_cross)) {
+			start.y += my;
+		}
+
+		if (start.x != destination.x && (start.y == destination.y || move_ver > move_hor || move_ver > move_cross)) {
+			start.x += mx;
+		}
+
+		const Tile* tile = map.getTile(start.x, start.y, start.z);
+		if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+			return false;
+		}
+	}
+
+	while (start.z != destination.z) {
+		const Tile* tile = map.getTile(start.x, start.y, start.z);
+		if (tile && tile->getThingCount() > 0) {
+			return false;
+		}
+
+		start.z++;
+	}
+
+	return true;
+}
+
+bool isSightClearTiles(const Map& map, const Position& fromPos, const Position& toPos)
+{
+	return checkSightLineTiles(map, fromPos, toPos) || checkSightLineTiles(map, toPos, fromPos);
+}
+
+}
+
+void benchmarkSight(const std::vector<Monster*>& monsters)
+{
+	Map& map = g_game.map;
+
+	// every monster looks at the creatures in its attack range, the way
+	// ranged monsters check their targets on each think
+	std::vector<SightCheckVector> batches;
+	batches.reserve(monsters.size());
+	size_t checkCount = 0;
+	for (const Monster* monster : monsters) {
+		const Position& pos = monster->getPosition();
+
+		SpectatorVec spectators;
+		map.getSpectators(spectators, pos, false, false, Map::maxClientViewportX, Map::maxClientViewportX, Map::maxClientViewportY, Map::maxClientViewportY);
+
+		SightCheckVector checks;
+		for (const Creature* spectator : spectators) {
+			if (spectator != monster) {
+				checks.emplace_back(pos, spectator->getPosition());
+			}
+		}
+		checkCount += checks.size();
+		batches.push_back(std::move(checks));
+	}
+
+	if (checkCount == 0) {
+		std::cout << "No creatures in sight of each other." << std::endl;
+		return;
+	}
+
+	size_t clearCount = 0;
+	std::vector<bool> results;
+	for (const SightCheckVector& checks : batches) {
+		map.isSightClear(checks, false, results);
+		for (size_t i = 0; i < checks.size(); ++i) {
+			if (results[i] != isSightClearTiles(map, checks[i].first, checks[i].second) ||
+			        results[i] != map.isSightClear(checks[i].first, checks[i].second, false)) {
+				std::cout << "Mismatch between the sight checks from " << checks[i].first << " to " << checks[i].second << '.' << std::endl;
+				return;
+			}
+			clearCount += results[i];
+		}
+	}
+
+	std::cout << monsters.size() << " monsters, " << checkCount << " lines of sight, " << clearCount << " clear, times per monster:" << std::endl;
+	runBenchmark("tile by tile, before the floor masks", batches.size(), [&](uint64_t i) {
+		uint64_t clear = 0;
+		for (const SightCheck& check : batches[i]) {
+			clear += isSightClearTiles(map, check.first, check.second);
+		}
+		return clear;
+	});
+	runBenchmark("Map::isSightClear", batches.size(), [&](uint64_t i) {
+		uint64_t clear = 0;
+		for (const SightCheck& check : batches[i]) {
+			clear += map.isSightClear(check.first, check.second, false);
+		}
+		return clear;
+	});
+	runBenchmark("Map::isSightClear, batched", batches.size(), [&](uint64_t i) {
+		map.isSightClear(batches[i], false, results);
+		return std::count(results.begin(), results.end(), true);
+	});
+}
@@ -0,0 +1,127 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "serverbenchmark.h"
+
+#include "game.h"
+#include "monster.h"
+
+#include <random>
+
+extern Game g_game;
+
+namespace {
+
+uint64_t countVisible(const Monster& monster, const Position& pos, const SpectatorVec& spectators)
+{
+	uint64_t visible = 0;
+	for (const Creature* spectator : spectators) {
+		if (spectator != &monster && Creature::canSee(pos, spectator->getPosition(), Monster::viewRangeX, Monster::viewRangeY)) {
+			++visible;
+		}
+	}
+	return visible;
+}
+
+// the scan of Monster::updateTargetList() after a step, the step itself
+// cleared the spectator cache
+uint64_t scanFull(Map& map, const Monster& monster)
+{
+	const Position& pos = monster.getPosition();
+
+	map.clearSpectatorCache();
+
+	SpectatorVec spectators;
+	map.getSpectators(spectators, pos, true);
+	return countVisible(monster, pos, spectators);
+}
+
+// the scan of Monster::updateTargetList(oldPos), only the strips that came into view
+uint64_t scanEdge(Map& map, const Monster& monster, const Position& oldPos)
+{
+	const Position& pos = monster.getPosition();
+	const int32_t stepX = pos.getX() - oldPos.getX();
+	const int32_t stepY = pos.getY() - oldPos.getY();
+
+	SpectatorVec spectators;
+	if (stepX != 0) {
+		const int32_t edgeX = stepX * Monster::viewRangeX;
+		map.getSpectators(spectators, pos, true, false, -edgeX, edgeX, Monster::viewRangeY, Monster::viewRangeY);
+	}
+
+	if (stepY != 0) {
+		const int32_t edgeY = stepY * Monster::viewRangeY;
+
+		SpectatorVec rowSpectators;
+		map.getSpectators(rowSpectators, pos, true, false, Monster::viewRangeX, Monster::viewRangeX, -edgeY, edgeY);
+		spectators.addSpectators(rowSpectators);
+	}
+	return countVisible(monster, pos, spectators);
+}
+
+}
+
+void benchmarkSpectators(const std::vector<Monster*>& monsters)
+{
+	if (monsters.empty()) {
+		return;
+	}
+
+	Map& map = g_game.map;
+
+	// the step each monster just took, in any of the eight directions
+	std::mt19937 generator(45);
+	std::uniform_int_distribution<int32_t> offset(-1, 1);
+	std::vector<Position> oldPositions;
+	oldPositions.reserve(monsters.size());
+	for (const Monster* monster : monsters) {
+		const Position& pos = monster->getPosition();
+		int32_t dx, dy;
+		do {
+			dx = offset(generator);
+			dy = offset(generator);
+		} while (dx == 0 && dy == 0);
+		oldPositions.emplace_back(pos.x - dx, pos.y - dy, pos.z);
+	}
+
+	uint64_t visibleCount = 0;
+	for (const Monster* monster : monsters) {
+		visibleCount += scanFull(map, *monster);
+	}
+
+	std::cout << monsters.size() << " monsters, " << static_cast<double>(visibleCount) / monsters.size() << " creatures in view on average:" << std::endl;
+	runBenchmark("full multifloor rescan after a step", monsters.size() * 4, [&](uint64_t i) {
+		return scanFull(map, *monsters[i % monsters.size()]);
+	});
+	runBenchmark("edge strip scan after a step", monsters.size() * 4, [&](uint64_t i) {
+		const size_t index = i % monsters.size();
+		return scanEdge(map, *monsters[index], oldPositions[index]);
+	});
+
+	// the whole step: map update, the onCreatureMove of everyone around and
+	// the moving monster's own target list update; every monster walks east
+	// and back west
+	runBenchmark("Game::internalMoveCreature, monster step", monsters.size() * 2, [&](uint64_t i) {
+		Monster* monster = monsters[i % monsters.size()];
+		const Direction direction = (i / monsters.size()) % 2 == 0 ? DIRECTION_EAST : DIRECTION_WEST;
+		return g_game.internalMoveCreature(monster, direction, FLAG_NOLIMIT) == RETURNVALUE_NOERROR;
+	});
+}
@@ -0,0 +1,120 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../src/storagemap.h"
+
+#include "benchmark.h"
+
+volatile uint64_t benchmarkSink = 0;
+
+namespace {
+
+// Compares StorageMap with the std::map<uint32_t, int32_t> the player
+// storage used to be kept in, for a light and a heavy quest player.
+void benchmarkStorage(size_t count)
+{
+	std::mt19937 generator(count);
+	std::vector<uint32_t> keys;
+	while (keys.size() < count) {
+		keys.push_back(std::uniform_int_distribution<uint32_t>(1000, 60000)(generator));
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	}
+
+	std::vector<uint32_t> lookups(4096);
+	for (uint32_t& key : lookups) {
+		key = keys[std::uniform_int_distribution<size_t>(0, count - 1)(generator)];
+	}
+
+	std::printf("%zu storage keys\n", count);
+
+	const uint64_t loads = std::max<uint64_t>(1, 2000000 / count);
+	runBenchmark("  std::map load", loads, [&](uint64_t) {
+		std::map<uint32_t, int32_t> storage;
+		for (uint32_t key : keys) {
+			storage.emplace(key, 1);
+		}
+		return storage.size();
+	});
+	runBenchmark("  StorageMap load", loads, [&](uint64_t) {
+		StorageMap storage;
+		for (uint32_t key : keys) {
+			storage.load(key, 1);
+		}
+		return storage.size();
+	});
+
+	std::map<uint32_t, int32_t> mapStorage;
+	StorageMap storageMap;
+	for (uint32_t key : keys) {
+		mapStorage.emplace(key, 1);
+		storageMap.load(key, 1);
+	}
+
+	runBenchmark("  std::map find", 10000000, [&](uint64_t i) {
+		auto it = mapStorage.find(lookups[i & 4095]);
+		return it != mapStorage.end() ? it->second : 0;
+	});
+	runBenchmark("  StorageMap find", 10000000, [&](uint64_t i) {
+		const int32_t* value = storageMap.find(lookups[i & 4095]);
+		return value ? *value : 0;
+	});
+
+	runBenchmark("  std::map set", 10000000, [&](uint64_t i) {
+		mapStorage[lookups[i & 4095]] = static_cast<int32_t>(i);
+		return 1;
+	});
+	runBenchmark("  StorageMap set", 10000000, [&](uint64_t i) {
+		storageMap.set(lookups[i & 4095], static_cast<int32_t>(i));
+		return 1;
+	});
+
+	// a save used to write every value, now it only writes the changed ones
+	const uint64_t saves = std::max<uint64_t>(1, 20000000 / count);
+	runBenchmark("  std::map save scan", saves, [&](uint64_t) {
+		uint64_t written = 0;
+		for (const auto& it : mapStorage) {
+			written += it.second != 0;
+		}
+		return written;
+	});
+	storageMap.clearDirty();
+	storageMap.set(keys.front(), -1);
+	runBenchmark("  StorageMap save scan, one value changed", saves, [&](uint64_t) {
+		uint64_t written = 0;
+		for (const StorageMap::Entry& entry : storageMap) {
+			written += entry.dirty;
+		}
+		return written;
+	});
+}
+
+}
+
+int main()
+{
+	benchmarkStorage(50);
+	benchmarkStorage(1000);
+	return 0;
+}
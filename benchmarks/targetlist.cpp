@@ -0,0 +1,200 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <list>
+#include <random>
+#include <vector>
+
+#include "../src/smallvector.h"
+
+#include "benchmark.h"
+
+volatile uint64_t benchmarkSink = 0;
+
+namespace {
+
+// Stand-in for the creatures in a monster's target list, with the outcome
+// of Monster::isTarget and canUseAttack decided up front.
+struct Target {
+	int32_t x;
+	int32_t y;
+	bool valid;
+	bool attackable;
+};
+
+int32_t getDistance(const Target& target)
+{
+	return std::abs(target.x) + std::abs(target.y);
+}
+
+// Replays what Monster::addTarget, searchTarget and removeTarget do with
+// the list, comparing SmallVector<Creature*, 8> with the std::list the
+// target list used to be.
+template <typename List>
+uint64_t replayTargetList(Target* targets, size_t count)
+{
+	List targetList;
+	for (size_t i = 0; i < count; ++i) {
+		if (std::find(targetList.begin(), targetList.end(), &targets[i]) == targetList.end()) {
+			targetList.push_back(&targets[i]);
+		}
+	}
+
+	uint64_t nearest = 0;
+	for (int round = 0; round < 4; ++round) {
+		for (Target* target : targetList) {
+			nearest = std::max<uint64_t>(nearest, target->x);
+		}
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		auto it = std::find(targetList.begin(), targetList.end(), &targets[i]);
+		if (it != targetList.end()) {
+			targetList.erase(it);
+		}
+	}
+	return nearest;
+}
+
+// The TARGETSEARCH_NEAREST selection of searchTarget before user-050: the
+// candidates are copied into a temporary list and scanned again, and the
+// whole target list a third time when none of them can be attacked.
+const Target* selectNearestBefore(const std::list<Target*>& targetList, const Target* followCreature)
+{
+	std::list<Target*> resultList;
+	for (Target* target : targetList) {
+		if (followCreature != target && target->valid && target->attackable) {
+			resultList.push_back(target);
+		}
+	}
+
+	const Target* result = nullptr;
+	if (!resultList.empty()) {
+		auto it = resultList.begin();
+		result = *it;
+
+		int32_t minRange = getDistance(*result);
+		while (++it != resultList.end()) {
+			int32_t distance = getDistance(**it);
+			if (distance < minRange) {
+				result = *it;
+				minRange = distance;
+			}
+		}
+	} else {
+		int32_t minRange = std::numeric_limits<int32_t>::max();
+		for (Target* target : targetList) {
+			if (!target->valid) {
+				continue;
+			}
+
+			int32_t distance = getDistance(*target);
+			if (distance < minRange) {
+				result = target;
+				minRange = distance;
+			}
+		}
+	}
+	return result;
+}
+
+// The single pass searchTarget does now
+const Target* selectNearestAfter(const SmallVector<Target*, 8>& targetList, const Target* followCreature)
+{
+	SmallVector<Target*, 8> resultList;
+	const Target* nearest = nullptr;
+	const Target* nearestTarget = nullptr;
+	int32_t minRange = std::numeric_limits<int32_t>::max();
+	int32_t minTargetRange = std::numeric_limits<int32_t>::max();
+
+	for (Target* target : targetList) {
+		if (!target->valid) {
+			continue;
+		}
+
+		const int32_t distance = getDistance(*target);
+		if (distance < minTargetRange) {
+			nearestTarget = target;
+			minTargetRange = distance;
+		}
+
+		if (followCreature != target && target->attackable) {
+			resultList.push_back(target);
+			if (distance < minRange) {
+				nearest = target;
+				minRange = distance;
+			}
+		}
+	}
+	return resultList.empty() ? nearestTarget : nearest;
+}
+
+void benchmarkTargets(size_t count, double attackableChance)
+{
+	std::mt19937 generator(count);
+	std::uniform_int_distribution<int32_t> offset(-8, 8);
+	std::bernoulli_distribution valid(0.9);
+	std::bernoulli_distribution attackable(attackableChance);
+
+	std::vector<Target> targets(count);
+	for (Target& target : targets) {
+		target = {offset(generator), offset(generator), valid(generator), attackable(generator)};
+	}
+
+	std::list<Target*> listTargets;
+	SmallVector<Target*, 8> vectorTargets;
+	for (Target& target : targets) {
+		listTargets.push_back(&target);
+		vectorTargets.push_back(&target);
+	}
+
+	if (selectNearestBefore(listTargets, &targets[0]) != selectNearestAfter(vectorTargets, &targets[0])) {
+		std::printf("selection mismatch for %zu targets\n", count);
+	}
+
+	std::printf("%zu targets, %.0f%% attackable\n", count, attackableChance * 100);
+	runBenchmark("  std::list add, scan and remove", 2000000, [&](uint64_t) {
+		return replayTargetList<std::list<Target*>>(targets.data(), count);
+	});
+	runBenchmark("  SmallVector add, scan and remove", 2000000, [&](uint64_t) {
+		return replayTargetList<SmallVector<Target*, 8>>(targets.data(), count);
+	});
+	runBenchmark("  searchTarget selection before", 5000000, [&](uint64_t) {
+		return reinterpret_cast<uintptr_t>(selectNearestBefore(listTargets, &targets[0]));
+	});
+	runBenchmark("  searchTarget selection after", 5000000, [&](uint64_t) {
+		return reinterpret_cast<uintptr_t>(selectNearestAfter(vectorTargets, &targets[0]));
+	});
+}
+
+}
+
+int main()
+{
+	benchmarkTargets(2, 0.7);
+	benchmarkTargets(8, 0.7);
+	// a crowded respawn where most of the crowd is out of reach
+	benchmarkTargets(24, 0.7);
+	benchmarkTargets(24, 0.0);
+	return 0;
+}
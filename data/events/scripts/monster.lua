@@ -6,12 +6,8 @@ function Monster:onDropLoot(corpse)
 	local player = Player(corpse:getCorpseOwner())
 	local mType = self:getType()
 	if not player or player:getStamina() > 840 then
-		local monsterLoot = mType:getLoot()
-		for i = 1, #monsterLoot do
-			local item = corpse:createLootItem(monsterLoot[i])
-			if not item then
-				print('[Warning] DropLoot:', 'Could not add loot item to corpse.')
-			end
+		if not mType:createLoot(corpse) then
+			print('[Warning] DropLoot:', 'Could not add loot item to corpse.')
 		end
 
 		if player then
@@ -33,3 +29,7 @@ function Monster:onDropLoot(corpse)
 		end
 	end
 end
+
+function Monster.onDropLootBatch(records)
+	-- records = {{monster = monster, corpse = corpse}, ...}
+end
@@ -276,3 +276,11 @@ function Player:onGainSkillTries(skill, tries)
 	end
 	return tries * configManager.getNumber(configKeys.RATE_SKILL)
 end
+
+function Player.onGainExperienceBatch(records)
+	-- records = {{player = player, source = source, exp = exp, rawExp = rawExp}, ...}
+end
+
+function Player.onGainSkillTriesBatch(records)
+	-- records = {{player = player, skill = skill, tries = tries}, ...}
+end
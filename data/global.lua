@@ -1,4 +1,5 @@
-math.randomseed(os.time())
+-- the seed printed on startup, setting it as randomSeed replays both sides
+math.randomseed(Game.getRandomSeed())
 dofile('data/lib/lib.lua')
 
 STORAGEVALUE_PROMOTION = 30018
@@ -0,0 +1,102 @@
+-- Calls per second of the hot userdata getters, the ones luajit.lua binds
+-- through the FFI on LuaJIT builds. Run the same suite on a Lua 5.1 build
+-- and on a LuaJIT build (luaFFIBindings on and off) to compare them.
+--
+-- In game: /luabench [calls]
+-- Standalone: lua5.1 data/lib/benchmark/bindings.lua [calls]
+--             luajit data/lib/benchmark/bindings.lua [calls]
+-- Without a server the suite runs against plain Lua stand-ins for the
+-- player and item, which measures what the interpreter itself adds to
+-- every method call and position access.
+LuaBenchmark = {}
+
+local function measure(iterations, callback)
+	local start = os.clock()
+	for _ = 1, iterations do
+		callback()
+	end
+	return os.clock() - start
+end
+
+local function getCases(player, item)
+	local position = player:getPosition()
+	local otherPosition = player:getPosition()
+
+	local cases = {
+		{"loop overhead", function() end},
+		{"Creature:getId", function() return player:getId() end},
+		{"Creature:getName", function() return player:getName() end},
+		{"Creature:getHealth", function() return player:getHealth() end},
+		{"Creature:getSpeed", function() return player:getSpeed() end},
+		{"Creature:getPosition", function() return player:getPosition() end},
+		{"Creature:getPosition().x", function() return player:getPosition().x end},
+		{"position.x + position.y", function() return position.x + position.y end},
+		{"position == position", function() return position == otherPosition end},
+		{"Player:getLevel", function() return player:getLevel() end},
+		{"Player:getMana", function() return player:getMana() end},
+		{"Player:getEffectiveSkillLevel", function() return player:getEffectiveSkillLevel(SKILL_SWORD) end},
+		{"Player:getStorageValue", function() return player:getStorageValue(1000) end},
+		{"Player:getItemCount", function() return player:getItemCount(2160) end},
+		{"Player:getMoney", function() return player:getMoney() end}
+	}
+
+	if item then
+		cases[#cases + 1] = {"Item:getId", function() return item:getId() end}
+		cases[#cases + 1] = {"Item:getCount", function() return item:getCount() end}
+		cases[#cases + 1] = {"Item:getPosition", function() return item:getPosition() end}
+		cases[#cases + 1] = {"Item:hasAttribute", function() return item:hasAttribute(ITEM_ATTRIBUTE_ACTIONID) end}
+	end
+	return cases
+end
+
+-- returns the report lines for iterations calls of every case
+function LuaBenchmark.run(iterations, player, item, bindings)
+	local lines = {string.format("Lua benchmark on %s with %s, %d calls each:", jit and jit.version or _VERSION, bindings, iterations)}
+	for _, case in ipairs(getCases(player, item)) do
+		local elapsed = measure(iterations, case[2])
+		local opsPerSecond = elapsed > 0 and iterations / elapsed or 0
+		lines[#lines + 1] = string.format("%s: %.0f ops/s (%.3f s)", case[1], opsPerSecond, elapsed)
+	end
+	return lines
+end
+
+-- stand-ins shaped like the server objects, for running outside the server
+local function createStandIns()
+	SKILL_SWORD = SKILL_SWORD or 2
+	ITEM_ATTRIBUTE_ACTIONID = ITEM_ATTRIBUTE_ACTIONID or 2
+
+	local positionMeta = {}
+	positionMeta.__eq = function(lhs, rhs) return lhs.x == rhs.x and lhs.y == rhs.y and lhs.z == rhs.z end
+
+	local PlayerStandIn = {}
+	PlayerStandIn.__index = PlayerStandIn
+	function PlayerStandIn:getId() return self.id end
+	function PlayerStandIn:getName() return self.name end
+	function PlayerStandIn:getHealth() return self.health end
+	function PlayerStandIn:getSpeed() return self.speed end
+	function PlayerStandIn:getPosition() return setmetatable({x = self.x, y = self.y, z = self.z, stackpos = 0}, positionMeta) end
+	function PlayerStandIn:getLevel() return self.level end
+	function PlayerStandIn:getMana() return self.mana end
+	function PlayerStandIn:getEffectiveSkillLevel(skill) return self.skills[skill] end
+	function PlayerStandIn:getStorageValue(key) return self.storage[key] or -1 end
+	function PlayerStandIn:getItemCount(itemId) return itemId == 2160 and 1 or 0 end
+	function PlayerStandIn:getMoney() return 10000 end
+
+	local ItemStandIn = {}
+	ItemStandIn.__index = ItemStandIn
+	function ItemStandIn:getId() return self.id end
+	function ItemStandIn:getCount() return self.count end
+	function ItemStandIn:getPosition() return setmetatable({x = 65535, y = 3, z = 0, stackpos = 0}, positionMeta) end
+	function ItemStandIn:hasAttribute(attribute) return self.attributes[attribute] ~= nil end
+
+	local player = setmetatable({id = 0x10000001, name = "Benchmark", health = 150, speed = 220, x = 1000, y = 1000, z = 7, level = 8, mana = 35,
+		skills = {[SKILL_SWORD] = 10}, storage = {[1000] = 1}}, PlayerStandIn)
+	local item = setmetatable({id = 1988, count = 1, attributes = {}}, ItemStandIn)
+	return player, item
+end
+
+if not Game then
+	local player, item = createStandIns()
+	local iterations = tonumber(arg and arg[1]) or 1000000
+	print(table.concat(LuaBenchmark.run(iterations, player, item, "plain Lua stand-ins"), "\n"))
+end
@@ -2,6 +2,7 @@ dofile('data/lib/core/combat.lua')
 dofile('data/lib/core/constants.lua')
 dofile('data/lib/core/container.lua')
 dofile('data/lib/core/creature.lua')
+dofile('data/lib/core/database.lua')
 dofile('data/lib/core/game.lua')
 dofile('data/lib/core/item.lua')
 dofile('data/lib/core/itemtype.lua')
@@ -11,3 +12,4 @@ dofile('data/lib/core/teleport.lua')
 dofile('data/lib/core/tile.lua')
 dofile('data/lib/core/vocation.lua')
 dofile('data/lib/core/party.lua')
+dofile('data/lib/core/luajit.lua')
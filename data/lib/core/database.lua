@@ -0,0 +1,15 @@
+-- Runs func as a coroutine, inside it db.awaitQuery and db.awaitStoreQuery
+-- suspend the script until the query thread answers instead of blocking
+-- the server. Userdata passed in may be removed while a query runs, look
+-- players and creatures up again by id after waiting.
+-- Result ids of db.awaitStoreQuery stay valid across later waits until
+-- result.free or the end of the coroutine; ids of db.storeQuery do not
+-- survive a wait, other scripts running meanwhile release them.
+function db.async(func, ...)
+	local co = coroutine.create(func)
+	local success, message = coroutine.resume(co, ...)
+	if not success then
+		error(debug.traceback(co, message), 0)
+	end
+	return co
+end
@@ -0,0 +1,315 @@
+-- Binds the hottest creature, item and player getters straight to the C entry
+-- points of src/luaffi.h when the server runs on LuaJIT. Calls through the
+-- regular bindings abort the JIT trace they appear in, FFI calls don't.
+if LuaFFI then
+	LuaFFI.active = false
+end
+
+if not jit or not configManager.getBoolean(configKeys.LUA_FFI_BINDINGS) then
+	return
+end
+
+local ok, ffi = pcall(require, "ffi")
+if not ok then
+	return
+end
+
+-- data/global.lua is executed again on reload, only declare the types once
+if not LuaFFI then
+	ffi.cdef[[
+		struct tfs_position {
+			uint16_t x;
+			uint16_t y;
+			uint8_t z;
+			int32_t stackpos;
+		};
+
+		int32_t tfs_ffi_abi_version();
+
+		uint32_t tfs_creature_get_id(const void* creature);
+		const char* tfs_creature_get_name(const void* creature);
+		int32_t tfs_creature_get_health(const void* creature);
+		int32_t tfs_creature_get_max_health(const void* creature);
+		int32_t tfs_creature_get_speed(const void* creature);
+		uint32_t tfs_creature_get_base_speed(const void* creature);
+		uint8_t tfs_creature_get_direction(const void* creature);
+		uint8_t tfs_creature_get_skull(const void* creature);
+		bool tfs_creature_is_removed(const void* creature);
+		bool tfs_creature_is_in_ghost_mode(const void* creature);
+		bool tfs_creature_is_health_hidden(const void* creature);
+		void tfs_creature_get_position(const void* creature, struct tfs_position* position);
+
+		uint16_t tfs_item_get_id(const void* item);
+		uint16_t tfs_item_get_count(const void* item);
+		uint16_t tfs_item_get_charges(const void* item);
+		uint16_t tfs_item_get_fluid_type(const void* item);
+		uint16_t tfs_item_get_sub_type(const void* item);
+		uint16_t tfs_item_get_action_id(const void* item);
+		uint32_t tfs_item_get_unique_id(void* item);
+		uint32_t tfs_item_get_weight(const void* item);
+		bool tfs_item_has_attribute(const void* item, int32_t attribute);
+		void tfs_item_get_position(const void* item, struct tfs_position* position);
+
+		uint32_t tfs_player_get_guid(const void* player);
+		uint32_t tfs_player_get_ip(const void* player);
+		double tfs_player_get_last_login_saved(const void* player);
+		uint32_t tfs_player_get_account_id(const void* player);
+		int32_t tfs_player_get_account_type(const void* player);
+		uint32_t tfs_player_get_level(const void* player);
+		double tfs_player_get_experience(const void* player);
+		uint32_t tfs_player_get_magic_level(const void* player);
+		uint32_t tfs_player_get_base_magic_level(const void* player);
+		uint32_t tfs_player_get_mana(const void* player);
+		uint32_t tfs_player_get_max_mana(const void* player);
+		double tfs_player_get_mana_spent(const void* player);
+		uint8_t tfs_player_get_soul(const void* player);
+		int32_t tfs_player_get_max_soul(const void* player);
+		uint32_t tfs_player_get_capacity(const void* player);
+		uint32_t tfs_player_get_free_capacity(const void* player);
+		int32_t tfs_player_get_skill_level(const void* player, int32_t skill);
+		int32_t tfs_player_get_effective_skill_level(const void* player, int32_t skill);
+		int32_t tfs_player_get_skill_percent(const void* player, int32_t skill);
+		uint16_t tfs_player_get_stamina(const void* player);
+		int32_t tfs_player_get_premium_days(const void* player);
+		int32_t tfs_player_get_sex(const void* player);
+		double tfs_player_get_skull_time(const void* player);
+		double tfs_player_get_bank_balance(const void* player);
+		double tfs_player_get_money(const void* player);
+		bool tfs_player_is_pz_locked(const void* player);
+		uint32_t tfs_player_get_item_count(const void* player, uint16_t itemId, int32_t subType);
+		int32_t tfs_player_get_storage_value(const void* player, uint32_t key);
+
+		uint32_t tfs_monster_get_friend_count(const void* monster);
+		uint32_t tfs_monster_get_target_count(const void* monster);
+	]]
+
+	-- Positions returned by the FFI getters are struct tfs_position cdata.
+	-- x, y, z and stackpos are plain struct fields, everything else behaves
+	-- like the Position userdata: the Position methods, other keys stored by
+	-- scripts, + and - and == against any kind of position. The C++ side
+	-- reads them through isPosition/getPosition like a table.
+	local positionFields = setmetatable({}, {__mode = "k"})
+	local newPosition
+
+	local function isPositionValue(value)
+		local valueType = type(value)
+		return valueType == "cdata" or valueType == "userdata" or valueType == "table"
+	end
+
+	local function combine(lhs, rhs, sign)
+		local stackpos = lhs.stackpos or 0
+		if stackpos == 0 then
+			stackpos = rhs.stackpos or 0
+		end
+		return newPosition(lhs.x + sign * (rhs.x or 0), lhs.y + sign * (rhs.y or 0), lhs.z + sign * (rhs.z or 0), stackpos)
+	end
+
+	newPosition = ffi.metatype("struct tfs_position", {
+		__index = function(self, key)
+			local method = Position[key]
+			if method ~= nil then
+				return method
+			end
+
+			local fields = positionFields[self]
+			return fields and fields[key]
+		end,
+		__newindex = function(self, key, value)
+			local fields = positionFields[self]
+			if not fields then
+				fields = {}
+				positionFields[self] = fields
+			end
+			fields[key] = value
+		end,
+		__eq = function(lhs, rhs)
+			if not isPositionValue(lhs) or not isPositionValue(rhs) then
+				return false
+			end
+			return lhs.x == rhs.x and lhs.y == rhs.y and lhs.z == rhs.z
+		end,
+		__add = function(lhs, rhs)
+			return combine(lhs, rhs, 1)
+		end,
+		__sub = function(lhs, rhs)
+			return combine(lhs, rhs, -1)
+		end
+	})
+
+	-- the regular bindings, kept for the argument types the FFI path doesn't handle
+	LuaFFI = {
+		itemHasAttribute = Item.hasAttribute,
+		newPosition = newPosition
+	}
+end
+
+local C = ffi.C
+
+-- the executable only exports the entry points when built with ENABLE_EXPORTS
+local ABI_VERSION = 4
+local exported, version = pcall(function() return C.tfs_ffi_abi_version() end)
+if not exported or version ~= ABI_VERSION then
+	print("[Warning - luajit.lua] FFI bindings unavailable, using the regular Lua bindings.")
+	return
+end
+
+LuaFFI.active = true
+
+local voidpp = ffi.typeof("void**")
+
+-- returns the object pointer stored in the userdata payload, nil where the
+-- regular binding would have found no object either; a Position userdata
+-- holds the position itself
+local function unwrap(self)
+	if type(self) ~= "userdata" or getmetatable(self) == Position then
+		return nil
+	end
+
+	local pointer = ffi.cast(voidpp, self)[0]
+	if pointer == nil then
+		return nil
+	end
+	return pointer
+end
+
+local function bind(class, name, getter)
+	class[name] = function(self)
+		local pointer = unwrap(self)
+		if not pointer then
+			return nil
+		end
+		return getter(pointer)
+	end
+end
+
+-- Creature
+bind(Creature, "getId", C.tfs_creature_get_id)
+bind(Creature, "getHealth", C.tfs_creature_get_health)
+bind(Creature, "getMaxHealth", C.tfs_creature_get_max_health)
+bind(Creature, "getSpeed", C.tfs_creature_get_speed)
+bind(Creature, "getBaseSpeed", C.tfs_creature_get_base_speed)
+bind(Creature, "getDirection", C.tfs_creature_get_direction)
+bind(Creature, "getSkull", C.tfs_creature_get_skull)
+bind(Creature, "isRemoved", C.tfs_creature_is_removed)
+bind(Creature, "isInGhostMode", C.tfs_creature_is_in_ghost_mode)
+bind(Creature, "isHealthHidden", C.tfs_creature_is_health_hidden)
+
+local getCreatureName = C.tfs_creature_get_name
+bind(Creature, "getName", function(pointer) return ffi.string(getCreatureName(pointer)) end)
+
+local newPosition = LuaFFI.newPosition
+local function positionGetter(getter)
+	return function(pointer)
+		local position = newPosition()
+		getter(pointer, position)
+		return position
+	end
+end
+
+bind(Creature, "getPosition", positionGetter(C.tfs_creature_get_position))
+
+-- Item
+bind(Item, "getId", C.tfs_item_get_id)
+bind(Item, "getCount", C.tfs_item_get_count)
+bind(Item, "getCharges", C.tfs_item_get_charges)
+bind(Item, "getFluidType", C.tfs_item_get_fluid_type)
+bind(Item, "getSubType", C.tfs_item_get_sub_type)
+bind(Item, "getActionId", C.tfs_item_get_action_id)
+bind(Item, "getUniqueId", C.tfs_item_get_unique_id)
+bind(Item, "getWeight", C.tfs_item_get_weight)
+bind(Item, "getPosition", positionGetter(C.tfs_item_get_position))
+
+local itemHasAttribute = C.tfs_item_has_attribute
+local classicItemHasAttribute = LuaFFI.itemHasAttribute
+function Item.hasAttribute(self, key)
+	if type(key) ~= "number" then
+		return classicItemHasAttribute(self, key)
+	end
+
+	local pointer = unwrap(self)
+	if not pointer then
+		return nil
+	end
+	return itemHasAttribute(pointer, key)
+end
+
+-- Player
+bind(Player, "getGuid", C.tfs_player_get_guid)
+bind(Player, "getIp", C.tfs_player_get_ip)
+bind(Player, "getLastLoginSaved", C.tfs_player_get_last_login_saved)
+bind(Player, "getAccountId", C.tfs_player_get_account_id)
+bind(Player, "getAccountType", C.tfs_player_get_account_type)
+bind(Player, "getLevel", C.tfs_player_get_level)
+bind(Player, "getExperience", C.tfs_player_get_experience)
+bind(Player, "getMagicLevel", C.tfs_player_get_magic_level)
+bind(Player, "getBaseMagicLevel", C.tfs_player_get_base_magic_level)
+bind(Player, "getMana", C.tfs_player_get_mana)
+bind(Player, "getMaxMana", C.tfs_player_get_max_mana)
+bind(Player, "getManaSpent", C.tfs_player_get_mana_spent)
+bind(Player, "getSoul", C.tfs_player_get_soul)
+bind(Player, "getCapacity", C.tfs_player_get_capacity)
+bind(Player, "getFreeCapacity", C.tfs_player_get_free_capacity)
+bind(Player, "getStamina", C.tfs_player_get_stamina)
+bind(Player, "getPremiumDays", C.tfs_player_get_premium_days)
+bind(Player, "getSex", C.tfs_player_get_sex)
+bind(Player, "getSkullTime", C.tfs_player_get_skull_time)
+bind(Player, "getBankBalance", C.tfs_player_get_bank_balance)
+bind(Player, "getMoney", C.tfs_player_get_money)
+bind(Player, "isPzLocked", C.tfs_player_is_pz_locked)
+
+-- the entry points return -1 where the regular binding returns nil
+local function bindOptional(class, name, getter)
+	class[name] = function(self, ...)
+		local pointer = unwrap(self)
+		if not pointer then
+			return nil
+		end
+
+		local value = getter(pointer, ...)
+		if value == -1 then
+			return nil
+		end
+		return value
+	end
+end
+
+local function skillGetter(getter)
+	return function(pointer, skillType)
+		return getter(pointer, tonumber(skillType) or 0)
+	end
+end
+
+local getMaxSoul = C.tfs_player_get_max_soul
+bindOptional(Player, "getMaxSoul", function(pointer) return getMaxSoul(pointer) end)
+bindOptional(Player, "getSkillLevel", skillGetter(C.tfs_player_get_skill_level))
+bindOptional(Player, "getEffectiveSkillLevel", skillGetter(C.tfs_player_get_effective_skill_level))
+bindOptional(Player, "getSkillPercent", skillGetter(C.tfs_player_get_skill_percent))
+
+local getItemCount = C.tfs_player_get_item_count
+function Player.getItemCount(self, itemId, subType)
+	local pointer = unwrap(self)
+	if not pointer then
+		return nil
+	end
+
+	if type(itemId) ~= "number" then
+		itemId = tonumber(itemId) or (type(itemId) == "string" and ItemType(itemId):getId()) or 0
+		if itemId == 0 then
+			return nil
+		end
+	end
+	return getItemCount(pointer, itemId, subType or -1)
+end
+
+local getStorageValue = C.tfs_player_get_storage_value
+function Player.getStorageValue(self, key)
+	local pointer = unwrap(self)
+	if not pointer then
+		return nil
+	end
+	return getStorageValue(pointer, tonumber(key) or 0)
+end
+
+-- Monster
+bind(Monster, "getFriendCount", C.tfs_monster_get_friend_count)
+bind(Monster, "getTargetCount", C.tfs_monster_get_target_count)
@@ -0,0 +1,30 @@
+-- Runs the binding benchmark suite in data/lib/benchmark/bindings.lua
+function onSay(player, words, param)
+	if not player:getGroup():getAccess() then
+		return true
+	end
+
+	if player:getAccountType() < ACCOUNT_TYPE_GOD then
+		return false
+	end
+
+	logCommand(player, words, param)
+
+	local iterations = math.min(math.max(tonumber(param) or 100000, 1000), 10000000)
+	local item = player:getSlotItem(CONST_SLOT_BACKPACK)
+
+	local bindings = "regular bindings"
+	if LuaFFI and LuaFFI.active then
+		bindings = "FFI bindings"
+	end
+
+	if not LuaBenchmark then
+		dofile('data/lib/benchmark/bindings.lua')
+	end
+	local lines = LuaBenchmark.run(iterations, player, item, bindings)
+
+	local report = table.concat(lines, "\n")
+	print(report)
+	player:showTextDialog(1949, report)
+	return false
+end
@@ -0,0 +1,42 @@
+function onSay(player, words, param)
+	if not player:getGroup():getAccess() then
+		return true
+	end
+
+	if player:getAccountType() < ACCOUNT_TYPE_GOD then
+		return false
+	end
+
+	logCommand(player, words, param)
+
+	local split = param:split(",")
+	local action = split[1] and split[1]:trim():lower() or ""
+	if action == "start" then
+		local sampleInterval = tonumber(split[2]) or 0
+		Game.startLuaProfiler(sampleInterval)
+		if sampleInterval > 0 then
+			player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, string.format("Lua profiler started, sampling every %d instructions.", sampleInterval))
+		else
+			player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, "Lua profiler started.")
+		end
+	elseif action == "stop" then
+		Game.stopLuaProfiler()
+		player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, "Lua profiler stopped.")
+	elseif action == "reset" then
+		Game.resetLuaProfiler()
+		player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, "Lua profiler data cleared.")
+	elseif action == "report" then
+		if Game.writeLuaProfilerReport() then
+			player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, "Lua profiler report written to data/logs/lua_profiler.log and data/logs/lua_profiler.folded.")
+		else
+			player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, "Failed to write the Lua profiler report.")
+		end
+	elseif action == "gc" then
+		local stats = Game.getLuaGarbageCollectorStats()
+		player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, string.format("Lua memory: %d KB, idle collector: %d cycles in %d steps, %d us total pause, %d us max pause.",
+			stats.memory, stats.cycles, stats.steps, stats.totalPause, stats.maxPause))
+	else
+		player:sendTextMessage(MESSAGE_STATUS_CONSOLE_BLUE, "Usage: /luaprofiler start[, sample interval] | stop | reset | report | gc")
+	end
+	return false
+end
@@ -36,6 +36,7 @@ Actions::Actions() :
 	scriptInterface("Action Interface")
 {
 	scriptInterface.initState();
+	scriptInterface.setBudgetConfig(ConfigManager::SCRIPT_BUDGET_ACTIONS);
 }
 
 Actions::~Actions()
@@ -59,10 +60,30 @@ void Actions::clear(bool fromLua)
 	clearMap(useItemMap, fromLua);
 	clearMap(uniqueItemMap, fromLua);
 	clearMap(actionItemMap, fromLua);
+	indexesDirty = true;
 
 	reInitState(fromLua);
 }
 
+void Actions::buildIndexes()
+{
+	useItemIndex.assign(useItemMap.empty() ? 0 : useItemMap.rbegin()->first + 1, nullptr);
+	for (auto& it : useItemMap) {
+		useItemIndex[it.first] = &it.second;
+	}
+
+	uniqueItemIndex.clear();
+	for (auto& it : uniqueItemMap) {
+		uniqueItemIndex.emplace(it.first, &it.second);
+	}
+
+	actionItemIndex.clear();
+	for (auto& it : actionItemMap) {
+		actionItemIndex.emplace(it.first, &it.second);
+	}
+	indexesDirty = false;
+}
+
 LuaScriptInterface& Actions::getScriptInterface()
 {
 	return scriptInterface;
@@ -84,6 +105,7 @@ Event_ptr Actions::getEvent(const std::string& nodeName)
 bool Actions::registerEvent(Event_ptr event, const pugi::xml_node& node)
 {
 	Action_ptr action{static_cast<Action*>(event.release())}; //event is guaranteed to be an Action
+	indexesDirty = true;
 
 	pugi::xml_attribute attr;
 	if ((attr = node.attribute("itemid"))) {
@@ -195,6 +217,7 @@ bool Actions::registerEvent(Event_ptr event, const pugi::xml_node& node)
 bool Actions::registerLuaEvent(Action* event)
 {
 	Action_ptr action{ event };
+	indexesDirty = true;
 	if (action->getItemIdRange().size() > 0) {
 		if (action->getItemIdRange().size() == 1) {
 			auto result = useItemMap.emplace(action->getItemIdRange().at(0), std::move(*action));
@@ -303,23 +326,25 @@ ReturnValue Actions::canUseFar(const Creature* creature, const Position& toPos,
 
 Action* Actions::getAction(const Item* item)
 {
+	if (indexesDirty) {
+		buildIndexes();
+	}
+
 	if (item->hasAttribute(ITEM_ATTRIBUTE_UNIQUEID)) {
-		auto it = uniqueItemMap.find(item->getUniqueId());
-		if (it != uniqueItemMap.end()) {
-			return &it->second;
+		if (Action* const* action = uniqueItemIndex.find(item->getUniqueId())) {
+			return *action;
 		}
 	}
 
 	if (item->hasAttribute(ITEM_ATTRIBUTE_ACTIONID)) {
-		auto it = actionItemMap.find(item->getActionId());
-		if (it != actionItemMap.end()) {
-			return &it->second;
+		if (Action* const* action = actionItemIndex.find(item->getActionId())) {
+			return *action;
 		}
 	}
 
-	auto it = useItemMap.find(item->getID());
-	if (it != useItemMap.end()) {
-		return &it->second;
+	const uint16_t itemId = item->getID();
+	if (itemId < useItemIndex.size() && useItemIndex[itemId]) {
+		return useItemIndex[itemId];
 	}
 
 	//rune items
@@ -22,6 +22,7 @@
 
 #include "baseevents.h"
 #include "enums.h"
+#include "flathashmap.h"
 #include "luascript.h"
 
 class Action;
@@ -135,8 +136,15 @@ class Actions final : public BaseEvents
 		ActionUseMap uniqueItemMap;
 		ActionUseMap actionItemMap;
 
+		// lookup indexes into the maps above, rebuilt after they change
+		std::vector<Action*> useItemIndex;
+		FlatHashMap<uint16_t, Action*> uniqueItemIndex;
+		FlatHashMap<uint16_t, Action*> actionItemIndex;
+		bool indexesDirty = true;
+
 		Action* getAction(const Item* item);
 		void clearMap(ActionUseMap& map, bool fromLua);
+		void buildIndexes();
 
 		LuaScriptInterface scriptInterface;
 };
@@ -258,7 +258,7 @@ bool ChatChannel::executeOnSpeakEvent(const Player& player, SpeakClasses& type,
 
 	bool result = false;
 	int size0 = lua_gettop(L);
-	int ret = scriptInterface->protectedCall(L, 3, 1);
+	int ret = LuaScriptInterface::instrumentedCall(L, 3, 1);
 	if (ret != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else if (lua_gettop(L) > 0) {
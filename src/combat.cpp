@@ -25,6 +25,7 @@
 #include "weapons.h"
 #include "configmanager.h"
 #include "events.h"
+#include "pool.h"
 
 extern Game g_game;
 extern Weapons* g_weapons;
@@ -83,7 +84,7 @@ CombatDamage Combat::getCombatDamage(Creature* creature, Creature* target) const
 	return damage;
 }
 
-void Combat::getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, std::forward_list<Tile*>& list)
+void Combat::getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, CombatTileList& list)
 {
 	if (targetPos.z >= MAP_MAX_LAYERS) {
 		return;
@@ -92,12 +93,7 @@ void Combat::getCombatArea(const Position& centerPos, const Position& targetPos,
 	if (area) {
 		area->getList(centerPos, targetPos, list);
 	} else {
-		Tile* tile = g_game.map.getTile(targetPos);
-		if (!tile) {
-			tile = new StaticTile(targetPos.x, targetPos.y, targetPos.z);
-			g_game.map.setTile(targetPos, tile);
-		}
-		list.push_front(tile);
+		list.emplace_back(targetPos, g_game.map.getTile(targetPos));
 	}
 }
 
@@ -676,7 +672,7 @@ void Combat::addDistanceEffect(Creature* caster, const Position& fromPos, const
 
 void Combat::CombatFunc(Creature* caster, const Position& pos, const AreaCombat* area, const CombatParams& params, CombatFunction func, CombatDamage* data)
 {
-	std::forward_list<Tile*> tileList;
+	CombatTileList tileList;
 
 	if (caster) {
 		getCombatArea(caster->getPosition(), pos, area, tileList);
@@ -688,8 +684,8 @@ void Combat::CombatFunc(Creature* caster, const Position& pos, const AreaCombat*
 	uint32_t maxY = 0;
 
 	//calculate the max viewable range
-	for (Tile* tile : tileList) {
-		const Position& tilePos = tile->getPosition();
+	for (const CombatTile& combatTile : tileList) {
+		const Position& tilePos = combatTile.position;
 
 		uint32_t diff = Position::getDistanceX(tilePos, pos);
 		if (diff > maxX) {
@@ -708,9 +704,27 @@ void Combat::CombatFunc(Creature* caster, const Position& pos, const AreaCombat*
 	SpectatorVec spectators;
 	g_game.map.getSpectators(spectators, pos, true, true, rangeX, rangeX, rangeY, rangeY);
 
+	// the targets' damage texts, effects and health bars reuse these spectators
+	CombatBatch batch(spectators, pos, maxX, maxY);
+
 	postCombatEffects(caster, pos, params);
 
-	for (Tile* tile : tileList) {
+	for (const CombatTile& combatTile : tileList) {
+		PlaceholderTile placeholder;
+		Tile* tile = combatTile.tile;
+		if (!tile) {
+			// an empty position only shows the impact effect, unless a
+			// script has to be handed a tile for it
+			if (!params.tileCallback && !g_events->hasCreatureOnAreaCombat()) {
+				if (params.impactEffect != CONST_ME_NONE && (!caster || caster->getPosition().z == combatTile.position.z)) {
+					Game::addMagicEffect(spectators, combatTile.position, params.impactEffect);
+				}
+				continue;
+			}
+
+			tile = placeholder.create(g_game.map, combatTile.position);
+		}
+
 		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
 			continue;
 		}
@@ -969,7 +983,7 @@ void ValueCallback::getMinMaxValues(Player* player, CombatDamage& damage, bool u
 	}
 
 	int size0 = lua_gettop(L);
-	if (lua_pcall(L, parameters, 2, 0) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, parameters, 2) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
 		damage.primary.value = normal_random(
@@ -1052,7 +1066,7 @@ void TargetCallback::onTargetCombat(Creature* creature, Creature* target) const
 
 	int size0 = lua_gettop(L);
 
-	if (lua_pcall(L, 2, 0 /*nReturnValues*/, 0) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 2, 0 /*nReturnValues*/) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	}
 
@@ -1067,21 +1081,23 @@ void TargetCallback::onTargetCombat(Creature* creature, Creature* target) const
 
 void AreaCombat::clear()
 {
-	for (const auto& it : areas) {
-		delete it.second;
+	for (MatrixArea*& area : areas) {
+		delete area;
+		area = nullptr;
 	}
-	areas.clear();
 }
 
 AreaCombat::AreaCombat(const AreaCombat& rhs)
 {
 	hasExtArea = rhs.hasExtArea;
-	for (const auto& it : rhs.areas) {
-		areas[it.first] = new MatrixArea(*it.second);
+	for (size_t i = 0; i < areas.size(); ++i) {
+		if (rhs.areas[i]) {
+			areas[i] = new MatrixArea(*rhs.areas[i]);
+		}
 	}
 }
 
-void AreaCombat::getList(const Position& centerPos, const Position& targetPos, std::forward_list<Tile*>& list) const
+void AreaCombat::getList(const Position& centerPos, const Position& targetPos, CombatTileList& list) const
 {
 	const MatrixArea* area = getArea(centerPos, targetPos);
 	if (!area) {
@@ -1091,25 +1107,16 @@ void AreaCombat::getList(const Position& centerPos, const Position& targetPos, s
 	uint32_t centerY, centerX;
 	area->getCenter(centerY, centerX);
 
-	Position tmpPos(targetPos.x - centerX, targetPos.y - centerY, targetPos.z);
-	uint32_t cols = area->getCols();
-	for (uint32_t y = 0, rows = area->getRows(); y < rows; ++y) {
-		for (uint32_t x = 0; x < cols; ++x) {
-			if (area->getValue(y, x) != 0) {
-				if (g_game.isSightClear(targetPos, tmpPos, true)) {
-					Tile* tile = g_game.map.getTile(tmpPos);
-					if (!tile) {
-						tile = new StaticTile(tmpPos.x, tmpPos.y, tmpPos.z);
-						g_game.map.setTile(tmpPos, tile);
-					}
-					list.push_front(tile);
-				}
-			}
-			tmpPos.x++;
+	// the sight lines of an area cross the same few map blocks, one floor
+	// mask cache serves all of them
+	const Map& map = g_game.map;
+	FloorMaskCache cache(FLOORMASK_BLOCKPROJECTILE);
+	area->forEachValue([&](uint32_t y, uint32_t x) {
+		Position pos(targetPos.x + x - centerX, targetPos.y + y - centerY, targetPos.z);
+		if (map.isSightClear(targetPos, pos, true, cache)) {
+			list.emplace_back(pos, map.getTile(pos));
 		}
-		tmpPos.x -= cols;
-		tmpPos.y++;
-	}
+	});
 }
 
 void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOperation_t op)
@@ -1120,7 +1127,7 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 	if (op == MATRIXOPERATION_COPY) {
 		for (uint32_t y = 0; y < input->getRows(); ++y) {
 			for (uint32_t x = 0; x < input->getCols(); ++x) {
-				(*output)[y][x] = (*input)[y][x];
+				output->setValue(y, x, input->getValue(y, x));
 			}
 		}
 
@@ -1129,7 +1136,7 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 		for (uint32_t y = 0; y < input->getRows(); ++y) {
 			uint32_t rx = 0;
 			for (int32_t x = input->getCols(); --x >= 0;) {
-				(*output)[y][rx++] = (*input)[y][x];
+				output->setValue(y, rx++, input->getValue(y, x));
 			}
 		}
 
@@ -1138,7 +1145,7 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 		for (uint32_t x = 0; x < input->getCols(); ++x) {
 			uint32_t ry = 0;
 			for (int32_t y = input->getRows(); --y >= 0;) {
-				(*output)[ry++][x] = (*input)[y][x];
+				output->setValue(ry++, x, input->getValue(y, x));
 			}
 		}
 
@@ -1186,7 +1193,7 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 				int32_t rotatedY = static_cast<int32_t>(round(newX * c + newY * d));
 
 				//write in the output matrix using rotated coordinates
-				(*output)[rotatedY + rotateCenterY][rotatedX + rotateCenterX] = (*input)[y][x];
+				output->setValue(rotatedY + rotateCenterY, rotatedX + rotateCenterX, input->getValue(y, x));
 			}
 		}
 
@@ -1354,6 +1361,16 @@ void AreaCombat::setupExtArea(const std::list<uint32_t>& list, uint32_t rows)
 
 //**********************************************************//
 
+void* MagicField::operator new(size_t size)
+{
+	return getSlabPool<MagicField>("magicfield").allocate(size);
+}
+
+void MagicField::operator delete(void* p, size_t size)
+{
+	getSlabPool<MagicField>("magicfield").deallocate(p, size);
+}
+
 void MagicField::onStepInField(Creature* creature)
 {
 	//remove magic walls/wild growth
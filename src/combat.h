@@ -24,6 +24,7 @@
 #include "condition.h"
 #include "map.h"
 #include "baseevents.h"
+#include "smallvector.h"
 
 class Condition;
 class Creature;
@@ -79,54 +80,40 @@ struct CombatParams {
 
 using CombatFunction = std::function<void(Creature*, Creature*, const CombatParams&, CombatDamage*)>;
 
+// Rows of an area packed into 64 bit words, one bit per cell
 class MatrixArea
 {
 	public:
-		MatrixArea(uint32_t rows, uint32_t cols): centerX(0), centerY(0), rows(rows), cols(cols) {
-			data_ = new bool*[rows];
-
-			for (uint32_t row = 0; row < rows; ++row) {
-				data_[row] = new bool[cols];
-
-				for (uint32_t col = 0; col < cols; ++col) {
-					data_[row][col] = 0;
-				}
+		MatrixArea(uint32_t rows, uint32_t cols) :
+			centerX(0), centerY(0), rows(rows), cols(cols), wordsPerRow((cols + 63) / 64), data_(rows * wordsPerRow) {}
+
+		void setValue(uint32_t row, uint32_t col, bool value) {
+			uint64_t& word = data_[row * wordsPerRow + col / 64];
+			const uint64_t bit = static_cast<uint64_t>(1) << (col % 64);
+			if (value) {
+				word |= bit;
+			} else {
+				word &= ~bit;
 			}
 		}
-
-		MatrixArea(const MatrixArea& rhs) {
-			centerX = rhs.centerX;
-			centerY = rhs.centerY;
-			rows = rhs.rows;
-			cols = rhs.cols;
-
-			data_ = new bool*[rows];
-
-			for (uint32_t row = 0; row < rows; ++row) {
-				data_[row] = new bool[cols];
-
-				for (uint32_t col = 0; col < cols; ++col) {
-					data_[row][col] = rhs.data_[row][col];
-				}
-			}
+		bool getValue(uint32_t row, uint32_t col) const {
+			return ((data_[row * wordsPerRow + col / 64] >> (col % 64)) & 1) != 0;
 		}
 
-		~MatrixArea() {
+		// calls func(row, col) for every set cell in row-major order, whole
+		// empty words are skipped
+		template <typename Function>
+		void forEachValue(Function&& func) const {
 			for (uint32_t row = 0; row < rows; ++row) {
-				delete[] data_[row];
+				for (uint32_t word = 0; word < wordsPerRow; ++word) {
+					uint64_t value = data_[row * wordsPerRow + word];
+					for (uint32_t col = word * 64; value != 0; value >>= 1, ++col) {
+						if ((value & 1) != 0) {
+							func(row, col);
+						}
+					}
+				}
 			}
-
-			delete[] data_;
-		}
-
-		// non-assignable
-		MatrixArea& operator=(const MatrixArea&) = delete;
-
-		void setValue(uint32_t row, uint32_t col, bool value) const {
-			data_[row][col] = value;
-		}
-		bool getValue(uint32_t row, uint32_t col) const {
-			return data_[row][col];
 		}
 
 		void setCenter(uint32_t y, uint32_t x) {
@@ -145,22 +132,27 @@ class MatrixArea
 			return cols;
 		}
 
-		const bool* operator[](uint32_t i) const {
-			return data_[i];
-		}
-		bool* operator[](uint32_t i) {
-			return data_[i];
-		}
-
 	private:
 		uint32_t centerX;
 		uint32_t centerY;
 
 		uint32_t rows;
 		uint32_t cols;
-		bool** data_;
+		uint32_t wordsPerRow;
+		std::vector<uint64_t> data_;
+};
+
+// A position hit by an area, tile is nullptr where the map has no tile;
+// such positions are not turned into tiles unless something needs one
+struct CombatTile {
+	CombatTile(const Position& position, Tile* tile) : position(position), tile(tile) {}
+
+	Position position;
+	Tile* tile;
 };
 
+using CombatTileList = SmallVector<CombatTile, 128>;
+
 class AreaCombat
 {
 	public:
@@ -174,7 +166,7 @@ class AreaCombat
 		// non-assignable
 		AreaCombat& operator=(const AreaCombat&) = delete;
 
-		void getList(const Position& centerPos, const Position& targetPos, std::forward_list<Tile*>& list) const;
+		void getList(const Position& centerPos, const Position& targetPos, CombatTileList& list) const;
 
 		void setupArea(const std::list<uint32_t>& list, uint32_t rows);
 		void setupArea(int32_t length, int32_t spread);
@@ -222,14 +214,11 @@ class AreaCombat
 				}
 			}
 
-			auto it = areas.find(dir);
-			if (it == areas.end()) {
-				return nullptr;
-			}
-			return it->second;
+			return areas[dir];
 		}
 
-		std::map<Direction, MatrixArea*> areas;
+		// every direction is rotated once at setup
+		std::array<MatrixArea*, DIRECTION_LAST + 1> areas {};
 		bool hasExtArea = false;
 };
 
@@ -254,7 +243,7 @@ class Combat
 		static void doCombatDispel(Creature* caster, Creature* target, const CombatParams& params);
 		static void doCombatDispel(Creature* caster, const Position& position, const AreaCombat* area, const CombatParams& params);
 
-		static void getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, std::forward_list<Tile*>& list);
+		static void getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, CombatTileList& list);
 
 		static bool isInPvpZone(const Creature* attacker, const Creature* target);
 		static bool isProtected(const Player* attacker, const Player* target);
@@ -328,6 +317,10 @@ class MagicField final : public Item
 	public:
 		explicit MagicField(uint16_t type) : Item(type), createTime(OTSYS_TIME()) {}
 
+		// allocated from a type-segregated slab pool
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		MagicField* getMagicField() override {
 			return this;
 		}
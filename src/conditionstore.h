@@ -0,0 +1,275 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_CONDITIONSTORE_H_C6D44640998B4A36951458A06D2A5B29
+#define FS_CONDITIONSTORE_H_C6D44640998B4A36951458A06D2A5B29
+
+#include "condition.h"
+
+// The conditions of a creature in the order they were added. A bitmask of
+// the types present answers most lookups without touching the conditions.
+// Conditions removed while an Iteration is open leave a hole behind, so
+// indexes stay valid; the holes are closed when the last Iteration ends.
+class ConditionStore
+{
+	public:
+		class Iteration
+		{
+			public:
+				explicit Iteration(ConditionStore& store) : store(store) {
+					++store.iterations;
+				}
+				~Iteration() {
+					if (--store.iterations == 0 && store.holes) {
+						store.compact();
+					}
+				}
+
+				// non-copyable
+				Iteration(const Iteration&) = delete;
+				Iteration& operator=(const Iteration&) = delete;
+
+			private:
+				ConditionStore& store;
+		};
+
+		class const_iterator
+		{
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = Condition*;
+				using difference_type = std::ptrdiff_t;
+				using pointer = Condition* const*;
+				using reference = Condition* const&;
+
+				const_iterator(std::vector<Condition*>::const_iterator it, std::vector<Condition*>::const_iterator end) : it(it), end(end) {
+					skipHoles();
+				}
+
+				reference operator*() const {
+					return *it;
+				}
+				const_iterator& operator++() {
+					++it;
+					skipHoles();
+					return *this;
+				}
+				bool operator==(const const_iterator& other) const {
+					return it == other.it;
+				}
+				bool operator!=(const const_iterator& other) const {
+					return it != other.it;
+				}
+
+			private:
+				void skipHoles() {
+					while (it != end && !*it) {
+						++it;
+					}
+				}
+
+				std::vector<Condition*>::const_iterator it;
+				std::vector<Condition*>::const_iterator end;
+		};
+
+		ConditionStore() = default;
+
+		// non-copyable
+		ConditionStore(const ConditionStore&) = delete;
+		ConditionStore& operator=(const ConditionStore&) = delete;
+
+		const_iterator begin() const {
+			return const_iterator(conditions.begin(), conditions.end());
+		}
+		const_iterator end() const {
+			return const_iterator(conditions.end(), conditions.end());
+		}
+
+		// number of slots, holes included
+		size_t size() const {
+			return conditions.size();
+		}
+		// nullptr for a hole
+		Condition* operator[](size_t index) const {
+			return conditions[index];
+		}
+
+		bool empty() const {
+			return count == 0;
+		}
+		bool hasType(ConditionType_t type) const {
+			return (typeMask & type) != 0;
+		}
+
+		bool contains(const Condition* condition) const {
+			return std::find(conditions.begin(), conditions.end(), condition) != conditions.end();
+		}
+
+		void add(Condition* condition) {
+			conditions.push_back(condition);
+			typeMask |= condition->getType();
+			++count;
+		}
+
+		bool remove(Condition* condition) {
+			auto it = std::find(conditions.begin(), conditions.end(), condition);
+			if (it == conditions.end()) {
+				return false;
+			}
+
+			if (iterations != 0) {
+				*it = nullptr;
+				holes = true;
+			} else {
+				conditions.erase(it);
+			}
+			--count;
+
+			typeMask = 0;
+			for (const Condition* remaining : conditions) {
+				if (remaining) {
+					typeMask |= remaining->getType();
+				}
+			}
+			return true;
+		}
+
+		Condition* find(ConditionType_t type) const {
+			if (!hasType(type)) {
+				return nullptr;
+			}
+
+			for (Condition* condition : conditions) {
+				if (condition && condition->getType() == type) {
+					return condition;
+				}
+			}
+			return nullptr;
+		}
+
+		Condition* find(ConditionType_t type, ConditionId_t conditionId, uint32_t subId) const {
+			if (!hasType(type)) {
+				return nullptr;
+			}
+
+			for (Condition* condition : conditions) {
+				if (condition && condition->getType() == type && condition->getId() == conditionId && condition->getSubId() == subId) {
+					return condition;
+				}
+			}
+			return nullptr;
+		}
+
+	private:
+		void compact() {
+			conditions.erase(std::remove(conditions.begin(), conditions.end(), nullptr), conditions.end());
+			holes = false;
+		}
+
+		std::vector<Condition*> conditions;
+		size_t count = 0;
+		uint32_t typeMask = 0;
+		uint32_t iterations = 0;
+		bool holes = false;
+};
+
+// Expiry times of the spell and spell group cooldowns. They never tick, so
+// they are kept as plain timestamps instead of conditions; expired entries
+// are dropped whenever a new cooldown is started.
+class CooldownTable
+{
+	public:
+		struct Entry {
+			Entry(ConditionType_t type, uint32_t id, int64_t endTime) : endTime(endTime), id(id), type(type) {}
+
+			int64_t endTime;
+			uint32_t id;
+			ConditionType_t type;
+		};
+
+		using const_iterator = std::vector<Entry>::const_iterator;
+
+		const_iterator begin() const {
+			return entries.begin();
+		}
+		const_iterator end() const {
+			return entries.end();
+		}
+
+		bool isActive(ConditionType_t type, uint32_t id, int64_t timeNow) const {
+			for (const Entry& entry : entries) {
+				if (entry.type == type && entry.id == id) {
+					return entry.endTime >= timeNow;
+				}
+			}
+			return false;
+		}
+
+		// keeps the later of both end times, returns false if the running cooldown lasts longer
+		bool start(ConditionType_t type, uint32_t id, int64_t endTime, int64_t timeNow) {
+			bool found = false;
+			auto it = entries.begin();
+			while (it != entries.end()) {
+				if (it->type == type && it->id == id) {
+					if (it->endTime > endTime) {
+						return false;
+					}
+					it->endTime = endTime;
+					found = true;
+					++it;
+				} else if (it->endTime < timeNow) {
+					it = entries.erase(it);
+				} else {
+					++it;
+				}
+			}
+
+			if (!found) {
+				entries.emplace_back(type, id, endTime);
+			}
+			return true;
+		}
+
+		void remove(ConditionType_t type) {
+			entries.erase(std::remove_if(entries.begin(), entries.end(), [type](const Entry& entry) {
+				return entry.type == type;
+			}), entries.end());
+		}
+
+		// returns false if the cooldown was not running
+		bool remove(ConditionType_t type, uint32_t id, int64_t timeNow) {
+			for (auto it = entries.begin(), end = entries.end(); it != end; ++it) {
+				if (it->type == type && it->id == id) {
+					const bool active = it->endTime >= timeNow;
+					entries.erase(it);
+					return active;
+				}
+			}
+			return false;
+		}
+
+		void clear() {
+			entries.clear();
+		}
+
+	private:
+		std::vector<Entry> entries;
+};
+
+#endif
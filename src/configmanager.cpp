@@ -145,6 +145,8 @@ bool ConfigManager::load()
 	boolean[SERVER_SAVE_CLEAN_MAP] = getGlobalBoolean(L, "serverSaveCleanMap", false);
 	boolean[SERVER_SAVE_CLOSE] = getGlobalBoolean(L, "serverSaveClose", false);
 	boolean[SERVER_SAVE_SHUTDOWN] = getGlobalBoolean(L, "serverSaveShutdown", true);
+	boolean[LUA_FFI_BINDINGS] = getGlobalBoolean(L, "luaFFIBindings", true);
+	boolean[LUA_BYTECODE_CACHE] = getGlobalBoolean(L, "luaBytecodeCache", false);
 
 	string[DEFAULT_PRIORITY] = getGlobalString(L, "defaultPriority", "high");
 	string[SERVER_NAME] = getGlobalString(L, "serverName", "");
@@ -182,6 +184,13 @@ bool ConfigManager::load()
 	integer[MAX_MARKET_OFFERS_AT_A_TIME_PER_PLAYER] = getGlobalNumber(L, "maxMarketOffersAtATimePerPlayer", 100);
 	integer[MAX_PACKETS_PER_SECOND] = getGlobalNumber(L, "maxPacketsPerSecond", 25);
 	integer[SERVER_SAVE_NOTIFY_DURATION] = getGlobalNumber(L, "serverSaveNotifyDuration", 5);
+	integer[SCRIPT_BUDGET] = getGlobalNumber(L, "scriptBudget", 0);
+	integer[SCRIPT_BUDGET_ACTIONS] = getGlobalNumber(L, "scriptBudgetActions", 0);
+	integer[SCRIPT_BUDGET_MOVEEVENTS] = getGlobalNumber(L, "scriptBudgetMoveEvents", 0);
+	integer[SCRIPT_BUDGET_GLOBALEVENTS] = getGlobalNumber(L, "scriptBudgetGlobalEvents", 0);
+	integer[SCRIPT_BUDGET_NPC] = getGlobalNumber(L, "scriptBudgetNpc", 0);
+	integer[DISPATCHER_WATCHDOG_TIME] = getGlobalNumber(L, "dispatcherWatchdogTime", 5000);
+	integer[RANDOM_SEED] = getGlobalNumber(L, "randomSeed", 0);
 
 	loaded = true;
 	lua_close(L);
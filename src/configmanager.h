@@ -47,6 +47,8 @@ class ConfigManager
 			SERVER_SAVE_CLEAN_MAP,
 			SERVER_SAVE_CLOSE,
 			SERVER_SAVE_SHUTDOWN,
+			LUA_FFI_BINDINGS,
+			LUA_BYTECODE_CACHE,
 
 			LAST_BOOLEAN_CONFIG /* this must be the last one */
 		};
@@ -106,6 +108,13 @@ class ConfigManager
 			EXP_FROM_PLAYERS_LEVEL_RANGE,
 			MAX_PACKETS_PER_SECOND,
 			SERVER_SAVE_NOTIFY_DURATION,
+			SCRIPT_BUDGET,
+			SCRIPT_BUDGET_ACTIONS,
+			SCRIPT_BUDGET_MOVEEVENTS,
+			SCRIPT_BUDGET_GLOBALEVENTS,
+			SCRIPT_BUDGET_NPC,
+			DISPATCHER_WATCHDOG_TIME,
+			RANDOM_SEED,
 
 			LAST_INTEGER_CONFIG /* this must be the last one */
 		};
@@ -22,6 +22,7 @@
 #include "container.h"
 #include "iomap.h"
 #include "game.h"
+#include "pool.h"
 
 extern Game g_game;
 
@@ -50,6 +51,16 @@ Container::Container(Tile* tile) : Container(ITEM_BROWSEFIELD, 30, false, true)
 	setParent(tile);
 }
 
+void* Container::operator new(size_t size)
+{
+	return getSlabPool<Container>("container").allocate(size);
+}
+
+void Container::operator delete(void* p, size_t size)
+{
+	getSlabPool<Container>("container").deallocate(p, size);
+}
+
 Container::~Container()
 {
 	if (getID() == ITEM_BROWSEFIELD) {
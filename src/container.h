@@ -54,6 +54,10 @@ class Container : public Item, public Cylinder
 		explicit Container(Tile* tile);
 		~Container();
 
+		// allocated from a type-segregated slab pool
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		// non-copyable
 		Container(const Container&) = delete;
 		Container& operator=(const Container&) = delete;
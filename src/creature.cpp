@@ -1138,6 +1138,12 @@ bool Creature::addCondition(Condition* condition, bool force/* = false*/)
 		}
 	}
 
+	if (isCooldown(condition)) {
+		addCooldown(condition->getType(), condition->getSubId(), condition->getTicks());
+		delete condition;
+		return true;
+	}
+
 	Condition* prevCond = getCondition(condition->getType(), condition->getId(), condition->getSubId());
 	if (prevCond) {
 		prevCond->addCondition(this, condition);
@@ -1146,7 +1152,7 @@ bool Creature::addCondition(Condition* condition, bool force/* = false*/)
 	}
 
 	if (condition->startCondition(this)) {
-		conditions.push_back(condition);
+		conditions.add(condition);
 		onAddCondition(condition->getType());
 		return true;
 	}
@@ -1170,11 +1176,18 @@ bool Creature::addCombatCondition(Condition* condition)
 
 void Creature::removeCondition(ConditionType_t type, bool force/* = false*/)
 {
-	auto it = conditions.begin(), end = conditions.end();
-	while (it != end) {
-		Condition* condition = *it;
-		if (condition->getType() != type) {
-			++it;
+	if (type == CONDITION_SPELLCOOLDOWN || type == CONDITION_SPELLGROUPCOOLDOWN) {
+		cooldowns.remove(type);
+	}
+
+	if (!conditions.hasType(type)) {
+		return;
+	}
+
+	ConditionStore::Iteration iteration(conditions);
+	for (size_t i = 0; i < conditions.size(); ++i) {
+		Condition* condition = conditions[i];
+		if (!condition || condition->getType() != type) {
 			continue;
 		}
 
@@ -1186,7 +1199,7 @@ void Creature::removeCondition(ConditionType_t type, bool force/* = false*/)
 			}
 		}
 
-		it = conditions.erase(it);
+		conditions.remove(condition);
 
 		condition->endCondition(this);
 		delete condition;
@@ -1197,11 +1210,18 @@ void Creature::removeCondition(ConditionType_t type, bool force/* = false*/)
 
 void Creature::removeCondition(ConditionType_t type, ConditionId_t conditionId, bool force/* = false*/)
 {
-	auto it = conditions.begin(), end = conditions.end();
-	while (it != end) {
-		Condition* condition = *it;
-		if (condition->getType() != type || condition->getId() != conditionId) {
-			++it;
+	if (conditionId == CONDITIONID_DEFAULT && (type == CONDITION_SPELLCOOLDOWN || type == CONDITION_SPELLGROUPCOOLDOWN)) {
+		cooldowns.remove(type);
+	}
+
+	if (!conditions.hasType(type)) {
+		return;
+	}
+
+	ConditionStore::Iteration iteration(conditions);
+	for (size_t i = 0; i < conditions.size(); ++i) {
+		Condition* condition = conditions[i];
+		if (!condition || condition->getType() != type || condition->getId() != conditionId) {
 			continue;
 		}
 
@@ -1213,7 +1233,7 @@ void Creature::removeCondition(ConditionType_t type, ConditionId_t conditionId,
 			}
 		}
 
-		it = conditions.erase(it);
+		conditions.remove(condition);
 
 		condition->endCondition(this);
 		delete condition;
@@ -1224,6 +1244,10 @@ void Creature::removeCondition(ConditionType_t type, ConditionId_t conditionId,
 
 void Creature::removeCombatCondition(ConditionType_t type)
 {
+	if (!conditions.hasType(type)) {
+		return;
+	}
+
 	std::vector<Condition*> removeConditions;
 	for (Condition* condition : conditions) {
 		if (condition->getType() == type) {
@@ -1238,8 +1262,7 @@ void Creature::removeCombatCondition(ConditionType_t type)
 
 void Creature::removeCondition(Condition* condition, bool force/* = false*/)
 {
-	auto it = std::find(conditions.begin(), conditions.end(), condition);
-	if (it == conditions.end()) {
+	if (!conditions.contains(condition)) {
 		return;
 	}
 
@@ -1251,7 +1274,7 @@ void Creature::removeCondition(Condition* condition, bool force/* = false*/)
 		}
 	}
 
-	conditions.erase(it);
+	conditions.remove(condition);
 
 	condition->endCondition(this);
 	onEndCondition(condition->getType());
@@ -1260,37 +1283,30 @@ void Creature::removeCondition(Condition* condition, bool force/* = false*/)
 
 Condition* Creature::getCondition(ConditionType_t type) const
 {
-	for (Condition* condition : conditions) {
-		if (condition->getType() == type) {
-			return condition;
-		}
-	}
-	return nullptr;
+	return conditions.find(type);
 }
 
 Condition* Creature::getCondition(ConditionType_t type, ConditionId_t conditionId, uint32_t subId/* = 0*/) const
 {
-	for (Condition* condition : conditions) {
-		if (condition->getType() == type && condition->getId() == conditionId && condition->getSubId() == subId) {
-			return condition;
-		}
-	}
-	return nullptr;
+	return conditions.find(type, conditionId, subId);
 }
 
 void Creature::executeConditions(uint32_t interval)
 {
-	ConditionList tempConditions{ conditions };
-	for (Condition* condition : tempConditions) {
-		auto it = std::find(conditions.begin(), conditions.end(), condition);
-		if (it == conditions.end()) {
+	if (conditions.empty()) {
+		return;
+	}
+
+	// conditions added meanwhile start ticking on the next think
+	ConditionStore::Iteration iteration(conditions);
+	for (size_t i = 0, size = conditions.size(); i < size; ++i) {
+		Condition* condition = conditions[i];
+		if (!condition) {
 			continue;
 		}
 
 		if (!condition->executeCondition(this, interval)) {
-			it = std::find(conditions.begin(), conditions.end(), condition);
-			if (it != conditions.end()) {
-				conditions.erase(it);
+			if (conditions.remove(condition)) {
 				condition->endCondition(this);
 				onEndCondition(condition->getType());
 				delete condition;
@@ -1299,6 +1315,37 @@ void Creature::executeConditions(uint32_t interval)
 	}
 }
 
+bool Creature::isCooldown(const Condition* condition)
+{
+	// cooldowns of other ids or without end stay regular conditions
+	ConditionType_t type = condition->getType();
+	return (type == CONDITION_SPELLCOOLDOWN || type == CONDITION_SPELLGROUPCOOLDOWN) && condition->getId() == CONDITIONID_DEFAULT && condition->getTicks() > 0;
+}
+
+void Creature::addCooldown(ConditionType_t type, uint32_t id, int32_t ticks)
+{
+	int64_t timeNow = OTSYS_TIME();
+	if (!cooldowns.start(type, id, timeNow + ticks, timeNow) || id == 0) {
+		return;
+	}
+
+	Player* player = getPlayer();
+	if (!player) {
+		return;
+	}
+
+	if (type == CONDITION_SPELLCOOLDOWN) {
+		player->sendSpellCooldown(id, ticks);
+	} else {
+		player->sendSpellGroupCooldown(static_cast<SpellGroup_t>(id), ticks);
+	}
+}
+
+bool Creature::removeCooldown(ConditionType_t type, uint32_t id)
+{
+	return cooldowns.remove(type, id, OTSYS_TIME());
+}
+
 bool Creature::hasCondition(ConditionType_t type, uint32_t subId/* = 0*/) const
 {
 	if (isSuppress(type)) {
@@ -1306,6 +1353,14 @@ bool Creature::hasCondition(ConditionType_t type, uint32_t subId/* = 0*/) const
 	}
 
 	int64_t timeNow = OTSYS_TIME();
+	if ((type == CONDITION_SPELLCOOLDOWN || type == CONDITION_SPELLGROUPCOOLDOWN) && cooldowns.isActive(type, subId, timeNow)) {
+		return true;
+	}
+
+	if (!conditions.hasType(type)) {
+		return false;
+	}
+
 	for (Condition* condition : conditions) {
 		if (condition->getType() != type || condition->getSubId() != subId) {
 			continue;
@@ -1363,7 +1418,7 @@ int64_t Creature::getStepDuration() const
 
 	Item* ground = tile->getGround();
 	if (ground) {
-		groundSpeed = Item::items[ground->getID()].speed;
+		groundSpeed = Item::items.getHotType(ground->getID()).speed;
 		if (groundSpeed == 0) {
 			groundSpeed = 150;
 		}
@@ -1571,9 +1626,7 @@ bool FrozenPathingConditionCall::operator()(const Position& startPos, const Posi
 
 bool Creature::isInvisible() const
 {
-	return std::find_if(conditions.begin(), conditions.end(), [] (const Condition* condition) {
-		return condition->getType() == CONDITION_INVISIBLE;
-	}) != conditions.end();
+	return conditions.hasType(CONDITION_INVISIBLE);
 }
 
 bool Creature::getPathTo(const Position& targetPos, std::forward_list<Direction>& dirList, const FindPathParams& fpp) const
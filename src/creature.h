@@ -23,12 +23,12 @@
 #include "map.h"
 #include "position.h"
 #include "condition.h"
+#include "conditionstore.h"
 #include "const.h"
 #include "tile.h"
 #include "enums.h"
 #include "creatureevent.h"
 
-using ConditionList = std::list<Condition*>;
 using CreatureEventList = std::list<CreatureEvent*>;
 
 enum slots_t : uint8_t {
@@ -316,6 +316,11 @@ class Creature : virtual public Thing
 		Condition* getCondition(ConditionType_t type) const;
 		Condition* getCondition(ConditionType_t type, ConditionId_t conditionId, uint32_t subId = 0) const;
 		void executeConditions(uint32_t interval);
+		void addCooldown(ConditionType_t type, uint32_t id, int32_t ticks);
+		bool removeCooldown(ConditionType_t type, uint32_t id);
+		const CooldownTable& getCooldowns() const {
+			return cooldowns;
+		}
 		bool hasCondition(ConditionType_t type, uint32_t subId = 0) const;
 		virtual bool isImmune(ConditionType_t type) const;
 		virtual bool isImmune(CombatType_t type) const;
@@ -479,7 +484,8 @@ class Creature : virtual public Thing
 
 		std::list<Creature*> summons;
 		CreatureEventList eventsList;
-		ConditionList conditions;
+		ConditionStore conditions;
+		CooldownTable cooldowns;
 
 		std::forward_list<Direction> listWalkDir;
 
@@ -518,6 +524,7 @@ class Creature : virtual public Thing
 		bool isUpdatingPath = false;
 		bool creatureCheck = false;
 		bool inCheckCreaturesVector = false;
+		bool sleeping = false;
 		bool skillLoss = true;
 		bool lootDrop = true;
 		bool cancelNextWalk = false;
@@ -553,6 +560,8 @@ class Creature : virtual public Thing
 		virtual bool dropCorpse(Creature* lastHitCreature, Creature* mostDamageCreature, bool lastHitUnjustified, bool mostDamageUnjustified);
 		virtual Item* getCorpse(Creature* lastHitCreature, Creature* mostDamageCreature);
 
+		static bool isCooldown(const Condition* condition);
+
 		friend class Game;
 		friend class Map;
 		friend class LuaScriptInterface;
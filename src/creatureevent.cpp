@@ -518,7 +518,7 @@ void CreatureEvent::executeHealthChange(Creature* creature, Creature* attacker,
 
 	LuaScriptInterface::pushCombatDamage(L, damage);
 
-	if (scriptInterface->protectedCall(L, 7, 4) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 7, 4) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
 		damage.primary.value = std::abs(LuaScriptInterface::getNumber<int32_t>(L, -4));
@@ -560,7 +560,7 @@ void CreatureEvent::executeManaChange(Creature* creature, Creature* attacker, Co
 
 	LuaScriptInterface::pushCombatDamage(L, damage);
 
-	if (scriptInterface->protectedCall(L, 7, 4) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 7, 4) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
 		damage.primary.value = LuaScriptInterface::getNumber<int32_t>(L, -4);
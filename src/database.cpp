@@ -250,6 +250,18 @@ DBInsert::DBInsert(std::string query) : query(std::move(query))
 	this->length = this->query.length();
 }
 
+void DBInsert::upsert(const std::vector<std::string>& columns)
+{
+	suffix = " ON DUPLICATE KEY UPDATE ";
+	for (size_t i = 0, size = columns.size(); i < size; ++i) {
+		if (i != 0) {
+			suffix.push_back(',');
+		}
+		suffix += '`' + columns[i] + "` = VALUES(`" + columns[i] + "`)";
+	}
+	length = query.length() + suffix.length();
+}
+
 bool DBInsert::addRow(const std::string& row)
 {
 	// adds new row to buffer
@@ -288,8 +300,8 @@ bool DBInsert::execute()
 	}
 
 	// executes buffer
-	bool res = Database::getInstance().executeQuery(query + values);
+	bool res = Database::getInstance().executeQuery(query + values + suffix);
 	values.clear();
-	length = query.length();
+	length = query.length() + suffix.length();
 	return res;
 }
@@ -190,6 +190,11 @@ class DBInsert
 {
 	public:
 		explicit DBInsert(std::string query);
+
+		// turns the insert into an update of the given columns for rows
+		// whose key already exists
+		void upsert(const std::vector<std::string>& columns);
+
 		bool addRow(const std::string& row);
 		bool addRow(std::ostringstream& row);
 		bool execute();
@@ -197,6 +202,7 @@ class DBInsert
 	private:
 		std::string query;
 		std::string values;
+		std::string suffix;
 		size_t length;
 };
 
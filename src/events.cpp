@@ -22,6 +22,7 @@
 #include "events.h"
 #include "tools.h"
 #include "item.h"
+#include "monster.h"
 #include "player.h"
 
 #include <set>
@@ -41,6 +42,9 @@ bool Events::load()
 		return false;
 	}
 
+	// deliver what is still pending to the handlers it was collected for
+	flushBatchedEvents();
+
 	info = {};
 
 	std::set<std::string> classes;
@@ -116,12 +120,18 @@ bool Events::load()
 				info.playerOnLoseExperience = event;
 			} else if (methodName == "onGainSkillTries") {
 				info.playerOnGainSkillTries = event;
+			} else if (methodName == "onGainExperienceBatch") {
+				info.playerOnGainExperienceBatch = event;
+			} else if (methodName == "onGainSkillTriesBatch") {
+				info.playerOnGainSkillTriesBatch = event;
 			} else {
 				std::cout << "[Warning - Events::load] Unknown player method: " << methodName << std::endl;
 			}
 		} else if (className == "Monster") {
 			if (methodName == "onDropLoot") {
 				info.monsterOnDropLoot = event;
+			} else if (methodName == "onDropLootBatch") {
+				info.monsterOnDropLootBatch = event;
 			} else {
 				std::cout << "[Warning - Events::load] Unknown monster method: " << methodName << std::endl;
 			}
@@ -190,7 +200,7 @@ ReturnValue Events::eventCreatureOnAreaCombat(Creature* creature, Tile* tile, bo
 	LuaScriptInterface::pushBoolean(L, aggressive);
 
 	ReturnValue returnValue;
-	if (scriptInterface.protectedCall(L, 3, 1) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 3, 1) != 0) {
 		returnValue = RETURNVALUE_NOTPOSSIBLE;
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
@@ -231,7 +241,7 @@ ReturnValue Events::eventCreatureOnTargetCombat(Creature* creature, Creature* ta
 	LuaScriptInterface::setCreatureMetatable(L, -1, target);
 
 	ReturnValue returnValue;
-	if (scriptInterface.protectedCall(L, 2, 1) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 2, 1) != 0) {
 		returnValue = RETURNVALUE_NOTPOSSIBLE;
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
@@ -345,7 +355,7 @@ void Events::eventPartyOnShareExperience(Party* party, uint64_t& exp)
 
 	lua_pushnumber(L, exp);
 
-	if (scriptInterface.protectedCall(L, 2, 1) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 2, 1) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
 		exp = LuaScriptInterface::getNumber<uint64_t>(L, -1);
@@ -761,6 +771,7 @@ void Events::eventPlayerOnGainExperience(Player* player, Creature* source, uint6
 	// Player:onGainExperience(source, exp, rawExp)
 	// rawExp gives the original exp which is not multiplied
 	if (info.playerOnGainExperience == -1) {
+		addGainExperienceRecord(player, source, exp, rawExp);
 		return;
 	}
 
@@ -788,7 +799,7 @@ void Events::eventPlayerOnGainExperience(Player* player, Creature* source, uint6
 	lua_pushnumber(L, exp);
 	lua_pushnumber(L, rawExp);
 
-	if (scriptInterface.protectedCall(L, 4, 1) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 4, 1) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
 		exp = LuaScriptInterface::getNumber<uint64_t>(L, -1);
@@ -796,6 +807,7 @@ void Events::eventPlayerOnGainExperience(Player* player, Creature* source, uint6
 	}
 
 	scriptInterface.resetScriptEnv();
+	addGainExperienceRecord(player, source, exp, rawExp);
 }
 
 void Events::eventPlayerOnLoseExperience(Player* player, uint64_t& exp)
@@ -821,7 +833,7 @@ void Events::eventPlayerOnLoseExperience(Player* player, uint64_t& exp)
 
 	lua_pushnumber(L, exp);
 
-	if (scriptInterface.protectedCall(L, 2, 1) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 2, 1) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
 		exp = LuaScriptInterface::getNumber<uint64_t>(L, -1);
@@ -835,6 +847,7 @@ void Events::eventPlayerOnGainSkillTries(Player* player, skills_t skill, uint64_
 {
 	// Player:onGainSkillTries(skill, tries)
 	if (info.playerOnGainSkillTries == -1) {
+		addGainSkillTriesRecord(player, skill, tries);
 		return;
 	}
 
@@ -855,7 +868,7 @@ void Events::eventPlayerOnGainSkillTries(Player* player, skills_t skill, uint64_
 	lua_pushnumber(L, skill);
 	lua_pushnumber(L, tries);
 
-	if (scriptInterface.protectedCall(L, 3, 1) != 0) {
+	if (LuaScriptInterface::instrumentedCall(L, 3, 1) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(L));
 	} else {
 		tries = LuaScriptInterface::getNumber<uint64_t>(L, -1);
@@ -863,11 +876,13 @@ void Events::eventPlayerOnGainSkillTries(Player* player, skills_t skill, uint64_
 	}
 
 	scriptInterface.resetScriptEnv();
+	addGainSkillTriesRecord(player, skill, tries);
 }
 
 void Events::eventMonsterOnDropLoot(Monster* monster, Container* corpse)
 {
 	// Monster:onDropLoot(corpse)
+	addDropLootRecord(monster, corpse);
 	if (info.monsterOnDropLoot == -1) {
 		return;
 	}
@@ -891,3 +906,188 @@ void Events::eventMonsterOnDropLoot(Monster* monster, Container* corpse)
 
 	return scriptInterface.callVoidFunction(2);
 }
+
+// Batched events
+// Records keep a reference to their objects until they have been delivered,
+// a monster dropping loot is usually removed before the task ends
+void Events::addGainExperienceRecord(Player* player, Creature* source, uint64_t exp, uint64_t rawExp)
+{
+	if (info.playerOnGainExperienceBatch == -1 || exp == 0) {
+		return;
+	}
+
+	player->incrementReferenceCounter();
+	if (source) {
+		source->incrementReferenceCounter();
+	}
+	gainExperienceRecords.push_back({player, source, exp, rawExp});
+}
+
+void Events::addGainSkillTriesRecord(Player* player, skills_t skill, uint64_t tries)
+{
+	if (info.playerOnGainSkillTriesBatch == -1 || tries == 0) {
+		return;
+	}
+
+	player->incrementReferenceCounter();
+	gainSkillTriesRecords.push_back({player, skill, tries});
+}
+
+void Events::addDropLootRecord(Monster* monster, Container* corpse)
+{
+	if (info.monsterOnDropLootBatch == -1) {
+		return;
+	}
+
+	monster->incrementReferenceCounter();
+	corpse->incrementReferenceCounter();
+	dropLootRecords.push_back({monster, corpse});
+}
+
+void Events::flushBatchedEvents()
+{
+	// handlers may cause new records, deliver those as well but never loop
+	// forever on a handler that keeps feeding itself
+	for (int round = 0; round < 4 && hasBatchedEvents(); ++round) {
+		flushGainExperienceRecords();
+		flushGainSkillTriesRecords();
+		flushDropLootRecords();
+	}
+}
+
+void Events::flushGainExperienceRecords()
+{
+	// Player.onGainExperienceBatch(records)
+	// records = {{player = player, source = source, exp = exp, rawExp = rawExp}, ...}
+	if (gainExperienceRecords.empty()) {
+		return;
+	}
+
+	std::vector<GainExperienceRecord> records;
+	records.swap(gainExperienceRecords);
+
+	if (info.playerOnGainExperienceBatch != -1 && scriptInterface.reserveScriptEnv()) {
+		ScriptEnvironment* env = scriptInterface.getScriptEnv();
+		env->setScriptId(info.playerOnGainExperienceBatch, &scriptInterface);
+
+		lua_State* L = scriptInterface.getLuaState();
+		scriptInterface.pushFunction(info.playerOnGainExperienceBatch);
+
+		lua_createtable(L, records.size(), 0);
+		int index = 0;
+		for (const GainExperienceRecord& record : records) {
+			lua_createtable(L, 0, 4);
+
+			LuaScriptInterface::pushUserdata<Player>(L, record.player);
+			LuaScriptInterface::setMetatable(L, -1, "Player");
+			lua_setfield(L, -2, "player");
+
+			if (record.source) {
+				LuaScriptInterface::pushUserdata<Creature>(L, record.source);
+				LuaScriptInterface::setCreatureMetatable(L, -1, record.source);
+				lua_setfield(L, -2, "source");
+			}
+
+			LuaScriptInterface::setField(L, "exp", record.exp);
+			LuaScriptInterface::setField(L, "rawExp", record.rawExp);
+			lua_rawseti(L, -2, ++index);
+		}
+
+		scriptInterface.callVoidFunction(1);
+	} else if (info.playerOnGainExperienceBatch != -1) {
+		std::cout << "[Error - Events::flushGainExperienceRecords] Call stack overflow" << std::endl;
+	}
+
+	for (const GainExperienceRecord& record : records) {
+		record.player->decrementReferenceCounter();
+		if (record.source) {
+			record.source->decrementReferenceCounter();
+		}
+	}
+}
+
+void Events::flushGainSkillTriesRecords()
+{
+	// Player.onGainSkillTriesBatch(records)
+	// records = {{player = player, skill = skill, tries = tries}, ...}
+	if (gainSkillTriesRecords.empty()) {
+		return;
+	}
+
+	std::vector<GainSkillTriesRecord> records;
+	records.swap(gainSkillTriesRecords);
+
+	if (info.playerOnGainSkillTriesBatch != -1 && scriptInterface.reserveScriptEnv()) {
+		ScriptEnvironment* env = scriptInterface.getScriptEnv();
+		env->setScriptId(info.playerOnGainSkillTriesBatch, &scriptInterface);
+
+		lua_State* L = scriptInterface.getLuaState();
+		scriptInterface.pushFunction(info.playerOnGainSkillTriesBatch);
+
+		lua_createtable(L, records.size(), 0);
+		int index = 0;
+		for (const GainSkillTriesRecord& record : records) {
+			lua_createtable(L, 0, 3);
+
+			LuaScriptInterface::pushUserdata<Player>(L, record.player);
+			LuaScriptInterface::setMetatable(L, -1, "Player");
+			lua_setfield(L, -2, "player");
+
+			LuaScriptInterface::setField(L, "skill", record.skill);
+			LuaScriptInterface::setField(L, "tries", record.tries);
+			lua_rawseti(L, -2, ++index);
+		}
+
+		scriptInterface.callVoidFunction(1);
+	} else if (info.playerOnGainSkillTriesBatch != -1) {
+		std::cout << "[Error - Events::flushGainSkillTriesRecords] Call stack overflow" << std::endl;
+	}
+
+	for (const GainSkillTriesRecord& record : records) {
+		record.player->decrementReferenceCounter();
+	}
+}
+
+void Events::flushDropLootRecords()
+{
+	// Monster.onDropLootBatch(records)
+	// records = {{monster = monster, corpse = corpse}, ...}
+	if (dropLootRecords.empty()) {
+		return;
+	}
+
+	std::vector<DropLootRecord> records;
+	records.swap(dropLootRecords);
+
+	if (info.monsterOnDropLootBatch != -1 && scriptInterface.reserveScriptEnv()) {
+		ScriptEnvironment* env = scriptInterface.getScriptEnv();
+		env->setScriptId(info.monsterOnDropLootBatch, &scriptInterface);
+
+		lua_State* L = scriptInterface.getLuaState();
+		scriptInterface.pushFunction(info.monsterOnDropLootBatch);
+
+		lua_createtable(L, records.size(), 0);
+		int index = 0;
+		for (const DropLootRecord& record : records) {
+			lua_createtable(L, 0, 2);
+
+			LuaScriptInterface::pushUserdata<Monster>(L, record.monster);
+			LuaScriptInterface::setMetatable(L, -1, "Monster");
+			lua_setfield(L, -2, "monster");
+
+			LuaScriptInterface::pushUserdata<Container>(L, record.corpse);
+			LuaScriptInterface::setMetatable(L, -1, "Container");
+			lua_setfield(L, -2, "corpse");
+			lua_rawseti(L, -2, ++index);
+		}
+
+		scriptInterface.callVoidFunction(1);
+	} else if (info.monsterOnDropLootBatch != -1) {
+		std::cout << "[Error - Events::flushDropLootRecords] Call stack overflow" << std::endl;
+	}
+
+	for (const DropLootRecord& record : records) {
+		record.monster->decrementReferenceCounter();
+		record.corpse->decrementReferenceCounter();
+	}
+}
@@ -25,6 +25,7 @@
 class Party;
 class ItemType;
 class Tile;
+class Monster;
 
 class Events
 {
@@ -60,6 +61,29 @@ class Events
 
 		// Monster
 		int32_t monsterOnDropLoot = -1;
+
+		// Batched, called once per dispatcher task with an array of records
+		int32_t playerOnGainExperienceBatch = -1;
+		int32_t playerOnGainSkillTriesBatch = -1;
+		int32_t monsterOnDropLootBatch = -1;
+	};
+
+	struct GainExperienceRecord {
+		Player* player;
+		Creature* source;
+		uint64_t exp;
+		uint64_t rawExp;
+	};
+
+	struct GainSkillTriesRecord {
+		Player* player;
+		skills_t skill;
+		uint64_t tries;
+	};
+
+	struct DropLootRecord {
+		Monster* monster;
+		Container* corpse;
 	};
 
 	public:
@@ -99,9 +123,33 @@ class Events
 		// Monster
 		void eventMonsterOnDropLoot(Monster* monster, Container* corpse);
 
+		// Creature:onAreaCombat receives the tile, areas only create tiles
+		// for empty positions while it is registered
+		bool hasCreatureOnAreaCombat() const {
+			return info.creatureOnAreaCombat != -1;
+		}
+
+		// Batched events, flushed by the dispatcher after every task
+		bool hasBatchedEvents() const {
+			return !gainExperienceRecords.empty() || !gainSkillTriesRecords.empty() || !dropLootRecords.empty();
+		}
+		void flushBatchedEvents();
+
 	private:
+		void addGainExperienceRecord(Player* player, Creature* source, uint64_t exp, uint64_t rawExp);
+		void addGainSkillTriesRecord(Player* player, skills_t skill, uint64_t tries);
+		void addDropLootRecord(Monster* monster, Container* corpse);
+
+		void flushGainExperienceRecords();
+		void flushGainSkillTriesRecords();
+		void flushDropLootRecords();
+
 		LuaScriptInterface scriptInterface;
 		EventsInfo info;
+
+		std::vector<GainExperienceRecord> gainExperienceRecords;
+		std::vector<GainSkillTriesRecord> gainSkillTriesRecords;
+		std::vector<DropLootRecord> dropLootRecords;
 };
 
 #endif
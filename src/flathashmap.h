@@ -0,0 +1,129 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_FLATHASHMAP_H_7AA1A84EFDDF41A186D919C5CE3D9A42
+#define FS_FLATHASHMAP_H_7AA1A84EFDDF41A186D919C5CE3D9A42
+
+#include "position.h"
+
+template <typename Key>
+struct FlatHash {
+	uint64_t operator()(const Key& key) const {
+		return static_cast<uint64_t>(key);
+	}
+};
+
+template <>
+struct FlatHash<Position> {
+	uint64_t operator()(const Position& pos) const {
+		return (static_cast<uint64_t>(pos.z) << 32) | (static_cast<uint64_t>(pos.y) << 16) | pos.x;
+	}
+};
+
+// Open addressing hash map with linear probing, meant for small lookup
+// indexes that are filled at load time and read on hot paths. Entries can
+// only be added; clear() and refill to remove them.
+template <typename Key, typename Value, typename Hash = FlatHash<Key>>
+class FlatHashMap
+{
+	public:
+		FlatHashMap() = default;
+
+		Value* find(const Key& key) {
+			return const_cast<Value*>(static_cast<const FlatHashMap*>(this)->find(key));
+		}
+		const Value* find(const Key& key) const {
+			if (count == 0) {
+				return nullptr;
+			}
+
+			for (size_t index = getBucket(key); ; index = (index + 1) & mask) {
+				const Slot& slot = slots[index];
+				if (!slot.used) {
+					return nullptr;
+				} else if (slot.key == key) {
+					return &slot.value;
+				}
+			}
+		}
+
+		// Adds the entry unless the key is already present, like std::map::emplace
+		bool emplace(const Key& key, const Value& value) {
+			if ((count + 1) * 4 > slots.size() * 3) {
+				rehash(std::max<size_t>(16, slots.size() * 2));
+			}
+
+			for (size_t index = getBucket(key); ; index = (index + 1) & mask) {
+				Slot& slot = slots[index];
+				if (!slot.used) {
+					slot.used = true;
+					slot.key = key;
+					slot.value = value;
+					++count;
+					return true;
+				} else if (slot.key == key) {
+					return false;
+				}
+			}
+		}
+
+		void clear() {
+			slots.clear();
+			mask = 0;
+			count = 0;
+		}
+
+		size_t size() const {
+			return count;
+		}
+		bool empty() const {
+			return count == 0;
+		}
+
+	private:
+		struct Slot {
+			Key key {};
+			Value value {};
+			bool used = false;
+		};
+
+		size_t getBucket(const Key& key) const {
+			// fibonacci hashing spreads the often sequential ids over the table
+			return static_cast<size_t>((Hash()(key) * 11400714819323198485ULL) >> 32) & mask;
+		}
+
+		void rehash(size_t size) {
+			std::vector<Slot> oldSlots(size);
+			oldSlots.swap(slots);
+			mask = size - 1;
+			count = 0;
+
+			for (const Slot& slot : oldSlots) {
+				if (slot.used) {
+					emplace(slot.key, slot.value);
+				}
+			}
+		}
+
+		std::vector<Slot> slots;
+		size_t mask = 0;
+		size_t count = 0;
+};
+
+#endif
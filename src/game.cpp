@@ -33,6 +33,7 @@
 #include "iologindata.h"
 #include "iomarket.h"
 #include "items.h"
+#include "luachunkcache.h"
 #include "monster.h"
 #include "movement.h"
 #include "scheduler.h"
@@ -84,6 +85,9 @@ void Game::start(ServiceManager* manager)
 	g_scheduler.addEvent(createSchedulerTask(EVENT_LIGHTINTERVAL, std::bind(&Game::checkLight, this)));
 	g_scheduler.addEvent(createSchedulerTask(EVENT_CREATURE_THINK_INTERVAL, std::bind(&Game::checkCreatures, this, 0)));
 	g_scheduler.addEvent(createSchedulerTask(EVENT_DECAYINTERVAL, std::bind(&Game::checkDecay, this)));
+
+	startupTileCount = map.getTileCount();
+	g_scheduler.addEvent(createSchedulerTask(EVENT_MAP_COMPACTION_INTERVAL, std::bind(&Game::compactMap, this)));
 }
 
 GameState_t Game::getGameState() const
@@ -578,6 +582,10 @@ bool Game::removeCreature(Creature* creature, bool isLogout/* = true*/)
 		}
 	}
 
+	if (creature->sleeping) {
+		map.removeSleeper(creature);
+	}
+
 	tile->removeCreature(creature);
 
 	const Position& tilePosition = tile->getPosition();
@@ -3497,6 +3505,11 @@ bool Game::isSightClear(const Position& fromPos, const Position& toPos, bool flo
 	return map.isSightClear(fromPos, toPos, floorCheck);
 }
 
+void Game::isSightClear(const SightCheckVector& checks, bool floorCheck, std::vector<bool>& results) const
+{
+	map.isSightClear(checks, floorCheck, results);
+}
+
 bool Game::internalCreatureTurn(Creature* creature, Direction dir)
 {
 	if (creature->getDirection() == dir) {
@@ -3586,6 +3599,10 @@ void Game::checkCreatureAttack(uint32_t creatureId)
 
 void Game::addCreatureCheck(Creature* creature)
 {
+	if (creature->sleeping) {
+		map.removeSleeper(creature);
+	}
+
 	creature->creatureCheck = true;
 
 	if (creature->inCheckCreaturesVector) {
@@ -3600,6 +3617,10 @@ void Game::addCreatureCheck(Creature* creature)
 
 void Game::removeCreatureCheck(Creature* creature)
 {
+	if (creature->sleeping) {
+		g_game.map.removeSleeper(creature);
+	}
+
 	if (creature->inCheckCreaturesVector) {
 		creature->creatureCheck = false;
 	}
@@ -3613,6 +3634,12 @@ void Game::checkCreatures(size_t index)
 	auto it = checkCreatureList.begin(), end = checkCreatureList.end();
 	while (it != end) {
 		Creature* creature = *it;
+		if (creature->creatureCheck && creature->getHealth() > 0 && !creature->getPlayer() && !map.isRegionActive(creature->getPosition())) {
+			// no player anywhere near, it sleeps until one comes close
+			map.addSleeper(creature);
+			creature->creatureCheck = false;
+		}
+
 		if (creature->creatureCheck) {
 			if (creature->getHealth() > 0) {
 				creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
@@ -3905,7 +3932,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 			message.primary.color = TEXTCOLOR_PASTELRED;
 
 			SpectatorVec spectators;
-			map.getSpectators(spectators, targetPos, false, true);
+			getCombatSpectators(spectators, targetPos, false);
 			for (Creature* spectator : spectators) {
 				Player* tmpPlayer = spectator->getPlayer();
 				if (tmpPlayer == attackerPlayer && attackerPlayer != targetPlayer) {
@@ -4019,7 +4046,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 				}
 
 				targetPlayer->drainMana(attacker, manaDamage);
-				map.getSpectators(spectators, targetPos, true, true);
+				getCombatSpectators(spectators, targetPos, true);
 				addMagicEffect(spectators, targetPos, CONST_ME_LOSEENERGY);
 
 				std::stringstream ss;
@@ -4113,7 +4140,7 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 		}
 
 		if (spectators.empty()) {
-			map.getSpectators(spectators, targetPos, true, true);
+			getCombatSpectators(spectators, targetPos, true);
 		}
 
 		message.primary.value = damage.primary.value;
@@ -4202,7 +4229,11 @@ bool Game::combatChangeHealth(Creature* attacker, Creature* target, CombatDamage
 		}
 
 		target->drainHealth(attacker, realDamage);
-		addCreatureHealth(spectators, target);
+		if (combatBatch) {
+			combatBatch->addCreatureHealth(target);
+		} else {
+			addCreatureHealth(spectators, target);
+		}
 	}
 
 	return true;
@@ -4302,7 +4333,7 @@ bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage&
 		message.primary.color = TEXTCOLOR_BLUE;
 
 		SpectatorVec spectators;
-		map.getSpectators(spectators, targetPos, false, true);
+		getCombatSpectators(spectators, targetPos, false);
 		for (Creature* spectator : spectators) {
 			Player* tmpPlayer = spectator->getPlayer();
 			if (tmpPlayer == attackerPlayer && attackerPlayer != targetPlayer) {
@@ -4349,6 +4380,11 @@ bool Game::combatChangeMana(Creature* attacker, Creature* target, CombatDamage&
 
 void Game::addCreatureHealth(const Creature* target)
 {
+	if (combatBatch) {
+		combatBatch->addCreatureHealth(target);
+		return;
+	}
+
 	SpectatorVec spectators;
 	map.getSpectators(spectators, target->getPosition(), true, true);
 	addCreatureHealth(spectators, target);
@@ -4366,7 +4402,7 @@ void Game::addCreatureHealth(const SpectatorVec& spectators, const Creature* tar
 void Game::addMagicEffect(const Position& pos, uint8_t effect)
 {
 	SpectatorVec spectators;
-	map.getSpectators(spectators, pos, true, true);
+	getCombatSpectators(spectators, pos, true);
 	addMagicEffect(spectators, pos, effect);
 }
 
@@ -4379,6 +4415,13 @@ void Game::addMagicEffect(const SpectatorVec& spectators, const Position& pos, u
 	}
 }
 
+void Game::getCombatSpectators(SpectatorVec& spectators, const Position& pos, bool multifloor)
+{
+	if (!combatBatch || !combatBatch->getSpectators(spectators, pos, multifloor)) {
+		map.getSpectators(spectators, pos, multifloor, true);
+	}
+}
+
 void Game::addDistanceEffect(const Position& fromPos, const Position& toPos, uint8_t effect)
 {
 	SpectatorVec spectators, toPosSpectators;
@@ -4529,6 +4572,24 @@ void Game::checkLight()
 	}
 }
 
+void Game::compactMap()
+{
+	g_scheduler.addEvent(createSchedulerTask(EVENT_MAP_COMPACTION_INTERVAL, std::bind(&Game::compactMap, this)));
+
+	bool passCompleted;
+	compactedTiles += map.compactEmptyTiles(MAP_COMPACTION_BLOCKS, passCompleted);
+	if (!passCompleted) {
+		return;
+	}
+
+	const size_t tileCount = map.getTileCount();
+	if (compactedTiles != 0 || tileCount != startupTileCount) {
+		std::cout << "> Map compaction removed " << compactedTiles << " empty tiles, "
+		          << tileCount << " tiles in use (" << static_cast<int64_t>(tileCount) - static_cast<int64_t>(startupTileCount) << " since startup)." << std::endl;
+	}
+	compactedTiles = 0;
+}
+
 LightInfo Game::getWorldLightInfo() const
 {
 	return {lightLevel, 0xD7};
@@ -5757,6 +5818,9 @@ bool Game::reload(ReloadTypes_t reloadType)
 		}
 
 		default: {
+			// a full reload also forgets scripts that were deleted or renamed
+			g_luaChunkCache.clear();
+
 			if (!g_spells->reload()) {
 				std::cout << "[Error - Game::reload] Failed to reload spells." << std::endl;
 				std::terminate();
@@ -5795,3 +5859,52 @@ bool Game::reload(ReloadTypes_t reloadType)
 	return true;
 }
 
+CombatBatch::CombatBatch(const SpectatorVec& spectators, const Position& centerPos, int32_t rangeX, int32_t rangeY) :
+	spectators(spectators), previous(g_game.combatBatch), centerPos(centerPos), rangeX(rangeX), rangeY(rangeY),
+	epoch(g_game.map.getPlayersSpectatorEpoch())
+{
+	g_game.combatBatch = this;
+}
+
+CombatBatch::~CombatBatch()
+{
+	for (const Creature* creature : healthChanges) {
+		if (creature->isRemoved()) {
+			continue;
+		}
+
+		SpectatorVec viewers;
+		if (!getSpectators(viewers, creature->getPosition(), true)) {
+			g_game.map.getSpectators(viewers, creature->getPosition(), true, true);
+		}
+		Game::addCreatureHealth(viewers, creature);
+	}
+
+	g_game.combatBatch = previous;
+}
+
+bool CombatBatch::getSpectators(SpectatorVec& spectators, const Position& pos, bool multifloor) const
+{
+	// the batch only knows the players around the area, and only as long as none of them moved
+	if (pos.z != centerPos.z || Position::getDistanceX(pos, centerPos) > rangeX || Position::getDistanceY(pos, centerPos) > rangeY) {
+		return false;
+	}
+
+	if (epoch != g_game.map.getPlayersSpectatorEpoch()) {
+		return false;
+	}
+
+	for (Creature* spectator : this->spectators) {
+		if (Map::isSpectatorOf(pos, spectator->getPosition(), multifloor)) {
+			spectators.emplace_back(spectator);
+		}
+	}
+	return true;
+}
+
+void CombatBatch::addCreatureHealth(const Creature* creature)
+{
+	if (std::find(healthChanges.begin(), healthChanges.end(), creature) == healthChanges.end()) {
+		healthChanges.push_back(creature);
+	}
+}
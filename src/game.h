@@ -73,6 +73,35 @@ enum LightState_t {
 static constexpr int32_t EVENT_LIGHTINTERVAL = 10000;
 static constexpr int32_t EVENT_DECAYINTERVAL = 250;
 static constexpr int32_t EVENT_DECAY_BUCKETS = 4;
+static constexpr int32_t EVENT_MAP_COMPACTION_INTERVAL = 1000;
+static constexpr uint32_t MAP_COMPACTION_BLOCKS = 64;
+
+/**
+  * Lends the spectators of an area combat to the notifications of its targets
+  * and sends each changed health bar once, when the combat is done.
+  */
+class CombatBatch
+{
+	public:
+		CombatBatch(const SpectatorVec& spectators, const Position& centerPos, int32_t rangeX, int32_t rangeY);
+		~CombatBatch();
+
+		// non-copyable
+		CombatBatch(const CombatBatch&) = delete;
+		CombatBatch& operator=(const CombatBatch&) = delete;
+
+		bool getSpectators(SpectatorVec& spectators, const Position& pos, bool multifloor) const;
+		void addCreatureHealth(const Creature* creature);
+
+	private:
+		const SpectatorVec& spectators;
+		std::vector<const Creature*> healthChanges;
+		CombatBatch* previous;
+		Position centerPos;
+		int32_t rangeX;
+		int32_t rangeY;
+		uint32_t epoch;
+};
 
 /**
   * Main Game class.
@@ -414,6 +443,7 @@ class Game
 		bool canThrowObjectTo(const Position& fromPos, const Position& toPos, bool checkLineOfSight = true,
 		                      int32_t rangex = Map::maxClientViewportX, int32_t rangey = Map::maxClientViewportY) const;
 		bool isSightClear(const Position& fromPos, const Position& toPos, bool floorCheck) const;
+		void isSightClear(const SightCheckVector& checks, bool floorCheck, std::vector<bool>& results) const;
 
 		void changeSpeed(Creature* creature, int32_t varSpeedDelta);
 		void internalCreatureChangeOutfit(Creature* creature, const Outfit_t& outfit);
@@ -435,6 +465,7 @@ class Game
 		void checkCreatureAttack(uint32_t creatureId);
 		void checkCreatures(size_t index);
 		void checkLight();
+		void compactMap();
 
 		bool combatBlockHit(CombatDamage& damage, Creature* attacker, Creature* target, bool checkDefense, bool checkArmor, bool field);
 
@@ -507,6 +538,10 @@ class Game
 		std::forward_list<Item*> toDecayItems;
 
 	private:
+		friend class CombatBatch;
+
+		void getCombatSpectators(SpectatorVec& spectators, const Position& pos, bool multifloor);
+
 		bool playerSaySpell(Player* player, SpeakClasses type, const std::string& text);
 		void playerWhisper(Player* player, const std::string& text);
 		bool playerYell(Player* player, const std::string& text);
@@ -530,6 +565,11 @@ class Game
 
 		size_t lastBucket = 0;
 
+		CombatBatch* combatBatch = nullptr;
+
+		size_t startupTileCount = 0;
+		uint32_t compactedTiles = 0;
+
 		WildcardTreeNode wildcardTree { false };
 
 		std::map<uint32_t, Npc*> npcs;
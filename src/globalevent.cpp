@@ -31,6 +31,7 @@ GlobalEvents::GlobalEvents() :
 	scriptInterface("GlobalEvent Interface")
 {
 	scriptInterface.initState();
+	scriptInterface.setBudgetConfig(ConfigManager::SCRIPT_BUDGET_GLOBALEVENTS);
 }
 
 GlobalEvents::~GlobalEvents()
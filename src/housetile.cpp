@@ -22,9 +22,20 @@
 #include "housetile.h"
 #include "house.h"
 #include "game.h"
+#include "pool.h"
 
 extern Game g_game;
 
+void* HouseTile::operator new(size_t size)
+{
+	return getSlabPool<HouseTile>("housetile").allocate(size);
+}
+
+void HouseTile::operator delete(void* p, size_t size)
+{
+	getSlabPool<HouseTile>("housetile").deallocate(p, size);
+}
+
 HouseTile::HouseTile(int32_t x, int32_t y, int32_t z, House* house) :
 	DynamicTile(x, y, z), house(house) {}
 
@@ -29,6 +29,10 @@ class HouseTile final : public DynamicTile
 	public:
 		HouseTile(int32_t x, int32_t y, int32_t z, House* house);
 
+		// allocated from a type-segregated slab pool
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		//cylinder implementations
 		ReturnValue queryAdd(int32_t index, const Thing& thing, uint32_t count,
 				uint32_t flags, Creature* actor = nullptr) const override;
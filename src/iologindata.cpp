@@ -543,7 +543,7 @@ bool IOLoginData::loadPlayer(Player* player, DBResult_ptr result)
 
 	//load storage map
 	query.str(std::string());
-	query << "SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = " << player->getGUID();
+	query << "SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = " << player->getGUID() << " ORDER BY `key`";
 	if ((result = db.storeQuery(query.str()))) {
 		do {
 			player->addStorageValue(result->getNumber<uint32_t>("key"), result->getNumber<int32_t>("value"), true);
@@ -655,6 +655,18 @@ bool IOLoginData::savePlayer(Player* player)
 		}
 	}
 
+	// cooldowns keep their condition format, they are turned back into table entries on login
+	int64_t timeNow = OTSYS_TIME();
+	for (const CooldownTable::Entry& cooldown : player->getCooldowns()) {
+		if (cooldown.endTime <= timeNow) {
+			continue;
+		}
+
+		std::unique_ptr<Condition> condition(Condition::createCondition(CONDITIONID_DEFAULT, cooldown.type, cooldown.endTime - timeNow, 0, false, cooldown.id));
+		condition->serialize(propWriteStream);
+		propWriteStream.write<uint8_t>(CONDITIONATTR_END);
+	}
+
 	size_t conditionsSize;
 	const char* conditions = propWriteStream.getStream(conditionsSize);
 
@@ -835,19 +847,37 @@ bool IOLoginData::savePlayer(Player* player)
 		return false;
 	}
 
-	query.str(std::string());
-	query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
+	//only write the storage values changed since the last save
+	player->genReservedStorageRange();
+
+	const std::vector<uint32_t>& removedKeys = player->storageMap.getRemovedKeys();
+	if (!removedKeys.empty()) {
+		query.str(std::string());
+		query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID() << " AND `key` IN (";
+		for (size_t i = 0, size = removedKeys.size(); i < size; ++i) {
+			if (i != 0) {
+				query << ',';
+			}
+			query << removedKeys[i];
+		}
+		query << ')';
+
+		if (!db.executeQuery(query.str())) {
+			return false;
+		}
 	}
 
 	query.str(std::string());
 
 	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
-	player->genReservedStorageRange();
+	storageQuery.upsert({"value"});
 
-	for (const auto& it : player->storageMap) {
-		query << player->getGUID() << ',' << it.first << ',' << it.second;
+	for (const StorageMap::Entry& entry : player->storageMap) {
+		if (!entry.dirty) {
+			continue;
+		}
+
+		query << player->getGUID() << ',' << entry.key << ',' << entry.value;
 		if (!storageQuery.addRow(query)) {
 			return false;
 		}
@@ -858,7 +888,12 @@ bool IOLoginData::savePlayer(Player* player)
 	}
 
 	//End the transaction
-	return transaction.commit();
+	if (!transaction.commit()) {
+		return false;
+	}
+
+	player->storageMap.clearDirty();
+	return true;
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid)
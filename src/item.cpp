@@ -30,6 +30,7 @@
 
 #include "actions.h"
 #include "spells.h"
+#include "pool.h"
 
 extern Game g_game;
 extern Spells* g_spells;
@@ -144,6 +145,16 @@ Item* Item::CreateItem(PropStream& propStream)
 	return Item::CreateItem(id, 0);
 }
 
+void* Item::operator new(size_t size)
+{
+	return getSlabPool<Item>("item", true).allocate(size);
+}
+
+void Item::operator delete(void* p, size_t size)
+{
+	getSlabPool<Item>("item", true).deallocate(p, size);
+}
+
 Item::Item(const uint16_t type, uint16_t count /*= 0*/) :
 	id(type)
 {
@@ -205,21 +216,19 @@ bool Item::equals(const Item* otherItem) const
 		return false;
 	}
 
+	// both lists are sorted by type and hold the same types
 	const auto& attributeList = attributes->attributes;
 	const auto& otherAttributeList = otherAttributes->attributes;
-	for (const auto& attribute : attributeList) {
+	for (size_t i = 0, size = attributeList.size(); i < size; ++i) {
+		const auto& attribute = attributeList[i];
+		const auto& otherAttribute = otherAttributeList[i];
 		if (ItemAttributes::isStrAttrType(attribute.type)) {
-			for (const auto& otherAttribute : otherAttributeList) {
-				if (attribute.type == otherAttribute.type && *attribute.value.string != *otherAttribute.value.string) {
-					return false;
-				}
-			}
-		} else {
-			for (const auto& otherAttribute : otherAttributeList) {
-				if (attribute.type == otherAttribute.type && attribute.value.integer != otherAttribute.value.integer) {
-					return false;
-				}
+			// interned, equal strings share the same pointer
+			if (attribute.value.string != otherAttribute.value.string) {
+				return false;
 			}
+		} else if (attribute.value.integer != otherAttribute.value.integer) {
+			return false;
 		}
 	}
 	return true;
@@ -810,20 +819,20 @@ void Item::serializeAttr(PropWriteStream& propWriteStream) const
 
 bool Item::hasProperty(ITEMPROPERTY prop) const
 {
-	const ItemType& it = items[id];
+	const ItemTypeHot& it = items.getHotType(id);
 	switch (prop) {
-		case CONST_PROP_BLOCKSOLID: return it.blockSolid;
-		case CONST_PROP_MOVEABLE: return it.moveable && !hasAttribute(ITEM_ATTRIBUTE_UNIQUEID);
-		case CONST_PROP_HASHEIGHT: return it.hasHeight;
-		case CONST_PROP_BLOCKPROJECTILE: return it.blockProjectile;
-		case CONST_PROP_BLOCKPATH: return it.blockPathFind;
-		case CONST_PROP_ISVERTICAL: return it.isVertical;
-		case CONST_PROP_ISHORIZONTAL: return it.isHorizontal;
-		case CONST_PROP_IMMOVABLEBLOCKSOLID: return it.blockSolid && (!it.moveable || hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
-		case CONST_PROP_IMMOVABLEBLOCKPATH: return it.blockPathFind && (!it.moveable || hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
-		case CONST_PROP_IMMOVABLENOFIELDBLOCKPATH: return !it.isMagicField() && it.blockPathFind && (!it.moveable || hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
-		case CONST_PROP_NOFIELDBLOCKPATH: return !it.isMagicField() && it.blockPathFind;
-		case CONST_PROP_SUPPORTHANGABLE: return it.isHorizontal || it.isVertical;
+		case CONST_PROP_BLOCKSOLID: return it.hasFlag(ITEMTYPE_FLAG_BLOCKSOLID);
+		case CONST_PROP_MOVEABLE: return it.hasFlag(ITEMTYPE_FLAG_MOVEABLE) && !hasAttribute(ITEM_ATTRIBUTE_UNIQUEID);
+		case CONST_PROP_HASHEIGHT: return it.hasFlag(ITEMTYPE_FLAG_HASHEIGHT);
+		case CONST_PROP_BLOCKPROJECTILE: return it.hasFlag(ITEMTYPE_FLAG_BLOCKPROJECTILE);
+		case CONST_PROP_BLOCKPATH: return it.hasFlag(ITEMTYPE_FLAG_BLOCKPATHFIND);
+		case CONST_PROP_ISVERTICAL: return it.hasFlag(ITEMTYPE_FLAG_VERTICAL);
+		case CONST_PROP_ISHORIZONTAL: return it.hasFlag(ITEMTYPE_FLAG_HORIZONTAL);
+		case CONST_PROP_IMMOVABLEBLOCKSOLID: return it.hasFlag(ITEMTYPE_FLAG_BLOCKSOLID) && (!it.hasFlag(ITEMTYPE_FLAG_MOVEABLE) || hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
+		case CONST_PROP_IMMOVABLEBLOCKPATH: return it.hasFlag(ITEMTYPE_FLAG_BLOCKPATHFIND) && (!it.hasFlag(ITEMTYPE_FLAG_MOVEABLE) || hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
+		case CONST_PROP_IMMOVABLENOFIELDBLOCKPATH: return !it.hasFlag(ITEMTYPE_FLAG_MAGICFIELD) && it.hasFlag(ITEMTYPE_FLAG_BLOCKPATHFIND) && (!it.hasFlag(ITEMTYPE_FLAG_MOVEABLE) || hasAttribute(ITEM_ATTRIBUTE_UNIQUEID));
+		case CONST_PROP_NOFIELDBLOCKPATH: return !it.hasFlag(ITEMTYPE_FLAG_MAGICFIELD) && it.hasFlag(ITEMTYPE_FLAG_BLOCKPATHFIND);
+		case CONST_PROP_SUPPORTHANGABLE: return it.hasFlag(ITEMTYPE_FLAG_HORIZONTAL | ITEMTYPE_FLAG_VERTICAL);
 		default: return false;
 	}
 }
@@ -1550,6 +1559,16 @@ void Item::setUniqueId(uint16_t n)
 
 	if (g_game.addUniqueItem(n, this)) {
 		getAttributes()->setUniqueId(n);
+		setTileMoveEventFlag();
+	}
+}
+
+void Item::setTileMoveEventFlag()
+{
+	// the item may now have a move event, make sure steps on its tile check it
+	Cylinder* parent = getParent();
+	if (Tile* tile = parent ? parent->getTile() : nullptr) {
+		tile->setFlag(TILESTATE_MOVEEVENT);
 	}
 }
 
@@ -1599,6 +1618,51 @@ int64_t ItemAttributes::emptyInt;
 double ItemAttributes::emptyDouble;
 bool ItemAttributes::emptyBool;
 
+namespace {
+
+typedef std::unordered_map<std::string, uint32_t> InternedStringMap;
+
+std::mutex internedStringsLock;
+
+InternedStringMap& getInternedStrings()
+{
+	// never destroyed, attributes may still be released during static destruction
+	static auto internedStrings = new InternedStringMap();
+	return *internedStrings;
+}
+
+}
+
+const std::string* ItemAttributes::acquireString(const std::string& value)
+{
+	std::lock_guard<std::mutex> lockGuard(internedStringsLock);
+	auto& entry = *getInternedStrings().emplace(value, 0).first;
+	++entry.second;
+	return &entry.first;
+}
+
+const std::string* ItemAttributes::acquireString(const std::string* value)
+{
+	std::lock_guard<std::mutex> lockGuard(internedStringsLock);
+	auto& entry = *getInternedStrings().find(*value);
+	++entry.second;
+	return value;
+}
+
+void ItemAttributes::releaseString(const std::string* value)
+{
+	if (!value) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lockGuard(internedStringsLock);
+	auto& internedStrings = getInternedStrings();
+	auto it = internedStrings.find(*value);
+	if (it != internedStrings.end() && --it->second == 0) {
+		internedStrings.erase(it);
+	}
+}
+
 const std::string& ItemAttributes::getStrAttr(itemAttrTypes type) const
 {
 	if (!isStrAttrType(type)) {
@@ -1606,7 +1670,7 @@ const std::string& ItemAttributes::getStrAttr(itemAttrTypes type) const
 	}
 
 	const Attribute* attr = getExistingAttr(type);
-	if (!attr) {
+	if (!attr || !attr->value.string) {
 		return emptyString;
 	}
 	return *attr->value.string;
@@ -1622,9 +1686,11 @@ void ItemAttributes::setStrAttr(itemAttrTypes type, const std::string& value)
 		return;
 	}
 
+	const std::string* string = acquireString(value);
+
 	Attribute& attr = getAttr(type);
-	delete attr.value.string;
-	attr.value.string = new std::string(value);
+	releaseString(attr.value.string);
+	attr.value.string = string;
 }
 
 void ItemAttributes::removeAttribute(itemAttrTypes type)
@@ -1633,19 +1699,7 @@ void ItemAttributes::removeAttribute(itemAttrTypes type)
 		return;
 	}
 
-	auto prev_it = attributes.cbegin();
-	if ((*prev_it).type == type) {
-		attributes.pop_front();
-	} else {
-		auto it = prev_it, end = attributes.cend();
-		while (++it != end) {
-			if ((*it).type == type) {
-				attributes.erase_after(prev_it);
-				break;
-			}
-			prev_it = it;
-		}
-	}
+	attributes.erase(attributes.begin() + getAttrIndex(type));
 	attributeBits &= ~type;
 }
 
@@ -1682,29 +1736,21 @@ void ItemAttributes::increaseIntAttr(itemAttrTypes type, int64_t value)
 
 const ItemAttributes::Attribute* ItemAttributes::getExistingAttr(itemAttrTypes type) const
 {
-	if (hasAttribute(type)) {
-		for (const Attribute& attribute : attributes) {
-			if (attribute.type == type) {
-				return &attribute;
-			}
-		}
+	if (!hasAttribute(type)) {
+		return nullptr;
 	}
-	return nullptr;
+	return &attributes[getAttrIndex(type)];
 }
 
 ItemAttributes::Attribute& ItemAttributes::getAttr(itemAttrTypes type)
 {
+	const size_t index = getAttrIndex(type);
 	if (hasAttribute(type)) {
-		for (Attribute& attribute : attributes) {
-			if (attribute.type == type) {
-				return attribute;
-			}
-		}
+		return attributes[index];
 	}
 
 	attributeBits |= type;
-	attributes.emplace_front(type);
-	return attributes.front();
+	return *attributes.emplace(attributes.begin() + index, type);
 }
 
 void Item::startDecaying()
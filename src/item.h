@@ -25,10 +25,12 @@
 #include "items.h"
 #include "luascript.h"
 #include "tools.h"
+#include "smallvector.h"
 #include <typeinfo>
 
 #include <boost/variant.hpp>
 #include <boost/lexical_cast.hpp>
+#include <bitset>
 #include <deque>
 
 class Creature;
@@ -350,11 +352,16 @@ class ItemAttributes
 
 		typedef std::unordered_map<std::string, CustomAttribute> CustomAttributeMap;
 
+		// Strings are interned and shared between all attributes holding the same text
+		static const std::string* acquireString(const std::string& value);
+		static const std::string* acquireString(const std::string* value);
+		static void releaseString(const std::string* value);
+
 		struct Attribute
 		{
 			union {
 				int64_t integer;
-				std::string* string;
+				const std::string* string;
 				CustomAttributeMap* custom;
 			} value;
 			itemAttrTypes type;
@@ -362,14 +369,13 @@ class ItemAttributes
 			explicit Attribute(itemAttrTypes type) : type(type) {
 				memset(&value, 0, sizeof(value));
 			}
-			Attribute(const Attribute& i) {
-				type = i.type;
+			Attribute(const Attribute& i) : type(i.type) {
 				if (ItemAttributes::isIntAttrType(type)) {
 					value.integer = i.value.integer;
 				} else if (ItemAttributes::isStrAttrType(type)) {
-					value.string = new std::string(*i.value.string);
+					value.string = i.value.string ? acquireString(i.value.string) : nullptr;
 				} else if (ItemAttributes::isCustomAttrType(type)) {
-					value.custom = new CustomAttributeMap(*i.value.custom);
+					value.custom = i.value.custom ? new CustomAttributeMap(*i.value.custom) : nullptr;
 				} else {
 					memset(&value, 0, sizeof(value));
 				}
@@ -379,23 +385,16 @@ class ItemAttributes
 				attribute.type = ITEM_ATTRIBUTE_NONE;
 			}
 			~Attribute() {
-				if (ItemAttributes::isStrAttrType(type)) {
-					delete value.string;
-				} else if (ItemAttributes::isCustomAttrType(type)) {
-					delete value.custom;
-				}
+				release();
 			}
-			Attribute& operator=(Attribute other) {
-				Attribute::swap(*this, other);
+			Attribute& operator=(const Attribute& other) {
+				Attribute tmp(other);
+				Attribute::swap(*this, tmp);
 				return *this;
 			}
 			Attribute& operator=(Attribute&& other) {
 				if (this != &other) {
-					if (ItemAttributes::isStrAttrType(type)) {
-						delete value.string;
-					} else if (ItemAttributes::isCustomAttrType(type)) {
-						delete value.custom;
-					}
+					release();
 
 					value = other.value;
 					type = other.type;
@@ -410,11 +409,28 @@ class ItemAttributes
 				std::swap(first.value, second.value);
 				std::swap(first.type, second.type);
 			}
+
+			private:
+				void release() {
+					if (ItemAttributes::isStrAttrType(type)) {
+						releaseString(value.string);
+					} else if (ItemAttributes::isCustomAttrType(type)) {
+						delete value.custom;
+					}
+				}
 		};
 
-		std::forward_list<Attribute> attributes;
+		// Kept sorted by type, so the position of an attribute is the number
+		// of lower attribute bits that are set.
+		typedef SmallVector<Attribute, 2> AttributeVector;
+
+		AttributeVector attributes;
 		uint32_t attributeBits = 0;
 
+		size_t getAttrIndex(itemAttrTypes type) const {
+			return std::bitset<32>(attributeBits & (type - 1)).count();
+		}
+
 		const std::string& getStrAttr(itemAttrTypes type) const;
 		void setStrAttr(itemAttrTypes type, const std::string& value);
 
@@ -515,7 +531,7 @@ class ItemAttributes
 			return (type & ITEM_ATTRIBUTE_CUSTOM) == type;
 		}
 
-		const std::forward_list<Attribute>& getList() const {
+		const AttributeVector& getList() const {
 			return attributes;
 		}
 
@@ -538,6 +554,10 @@ class Item : virtual public Thing
 
 		virtual ~Item() = default;
 
+		// allocated from a type-segregated slab pool
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		// non-assignable
 		Item& operator=(const Item&) = delete;
 
@@ -604,6 +624,9 @@ class Item : virtual public Thing
 		}
 		void setIntAttr(itemAttrTypes type, int32_t value) {
 			getAttributes()->setIntAttr(type, value);
+			if (type == ITEM_ATTRIBUTE_ACTIONID || type == ITEM_ATTRIBUTE_UNIQUEID) {
+				setTileMoveEventFlag();
+			}
 		}
 		void increaseIntAttr(itemAttrTypes type, int32_t value) {
 			getAttributes()->increaseIntAttr(type, value);
@@ -828,7 +851,7 @@ class Item : virtual public Thing
 			if (hasAttribute(ITEM_ATTRIBUTE_WEIGHT)) {
 				return getIntAttr(ITEM_ATTRIBUTE_WEIGHT);
 			}
-			return items[id].weight;
+			return items.getHotType(id).weight;
 		}
 		int32_t getAttack() const {
 			if (hasAttribute(ITEM_ATTRIBUTE_ATTACK)) {
@@ -869,38 +892,38 @@ class Item : virtual public Thing
 
 		bool hasProperty(ITEMPROPERTY prop) const;
 		bool isBlocking() const {
-			return items[id].blockSolid;
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_BLOCKSOLID);
 		}
 		bool isStackable() const {
-			return items[id].stackable;
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_STACKABLE);
 		}
 		bool isAlwaysOnTop() const {
-			return items[id].alwaysOnTop;
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_ALWAYSONTOP);
 		}
 		bool isGroundTile() const {
-			return items[id].isGroundTile();
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_GROUND);
 		}
 		bool isMagicField() const {
-			return items[id].isMagicField();
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_MAGICFIELD);
 		}
 		bool isMoveable() const {
-			return items[id].moveable;
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_MOVEABLE);
 		}
 		bool isPickupable() const {
-			return items[id].pickupable;
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_PICKUPABLE);
 		}
 		bool isUseable() const {
-			return items[id].useable;
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_USEABLE);
 		}
 		bool isHangable() const {
-			return items[id].isHangable;
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_HANGABLE);
 		}
 		bool isRotatable() const {
 			const ItemType& it = items[id];
 			return it.rotatable && it.rotateTo;
 		}
 		bool hasWalkStack() const {
-			return items[id].walkStack;
+			return items.getHotType(id).hasFlag(ITEMTYPE_FLAG_WALKSTACK);
 		}
 
 		const std::string& getName() const {
@@ -943,6 +966,7 @@ class Item : virtual public Thing
 		void setSubType(uint16_t n);
 
 		void setUniqueId(uint16_t n);
+		void setTileMoveEventFlag();
 
 		void setDefaultDuration() {
 			uint32_t duration = getDefaultDuration();
@@ -221,6 +221,7 @@ Items::Items()
 void Items::clear()
 {
 	items.clear();
+	hotItems.clear();
 	reverseItemMap.clear();
 	nameToItems.clear();
 }
@@ -511,6 +512,7 @@ bool Items::loadFromXml()
 	}
 
 	buildInventoryList();
+	buildHotList();
 	return true;
 }
 
@@ -536,6 +538,88 @@ void Items::buildInventoryList()
 	std::sort(inventory.begin(), inventory.end());
 }
 
+void Items::buildHotList()
+{
+	hotItems.clear();
+	hotItems.resize(items.size());
+
+	for (size_t id = 0, size = items.size(); id < size; ++id) {
+		const ItemType& type = items[id];
+		ItemTypeHot& hot = hotItems[id];
+
+		uint32_t flags = 0;
+		if (type.blockSolid) {
+			flags |= ITEMTYPE_FLAG_BLOCKSOLID;
+		}
+		if (type.blockProjectile) {
+			flags |= ITEMTYPE_FLAG_BLOCKPROJECTILE;
+		}
+		if (type.blockPathFind) {
+			flags |= ITEMTYPE_FLAG_BLOCKPATHFIND;
+		}
+		if (type.hasHeight) {
+			flags |= ITEMTYPE_FLAG_HASHEIGHT;
+		}
+		if (type.moveable) {
+			flags |= ITEMTYPE_FLAG_MOVEABLE;
+		}
+		if (type.pickupable) {
+			flags |= ITEMTYPE_FLAG_PICKUPABLE;
+		}
+		if (type.allowPickupable) {
+			flags |= ITEMTYPE_FLAG_ALLOWPICKUPABLE;
+		}
+		if (type.stackable) {
+			flags |= ITEMTYPE_FLAG_STACKABLE;
+		}
+		if (type.alwaysOnTop) {
+			flags |= ITEMTYPE_FLAG_ALWAYSONTOP;
+		}
+		if (type.isVertical) {
+			flags |= ITEMTYPE_FLAG_VERTICAL;
+		}
+		if (type.isHorizontal) {
+			flags |= ITEMTYPE_FLAG_HORIZONTAL;
+		}
+		if (type.isHangable) {
+			flags |= ITEMTYPE_FLAG_HANGABLE;
+		}
+		if (type.useable) {
+			flags |= ITEMTYPE_FLAG_USEABLE;
+		}
+		if (type.lookThrough) {
+			flags |= ITEMTYPE_FLAG_LOOKTHROUGH;
+		}
+		if (type.walkStack) {
+			flags |= ITEMTYPE_FLAG_WALKSTACK;
+		}
+		if (type.isGroundTile()) {
+			flags |= ITEMTYPE_FLAG_GROUND;
+		}
+		if (type.isSplash()) {
+			flags |= ITEMTYPE_FLAG_SPLASH;
+		}
+		if (type.isContainer()) {
+			flags |= ITEMTYPE_FLAG_CONTAINER;
+		}
+		if (type.isMagicField()) {
+			flags |= ITEMTYPE_FLAG_MAGICFIELD;
+		}
+		if (type.isTeleport()) {
+			flags |= ITEMTYPE_FLAG_TELEPORT;
+		}
+		if (type.isBed()) {
+			flags |= ITEMTYPE_FLAG_BED;
+		}
+
+		hot.flags = flags;
+		hot.weight = type.weight;
+		hot.speed = type.speed;
+		hot.alwaysOnTopOrder = type.alwaysOnTopOrder;
+		hot.floorChange = type.floorChange;
+	}
+}
+
 void Items::parseItemNode(const pugi::xml_node& itemNode, uint16_t id)
 {
 	if (id > 30000 && id < 30100) {
@@ -201,6 +201,46 @@ struct Abilities {
 	bool regeneration = false;
 };
 
+enum ItemTypeFlags_t : uint32_t {
+	ITEMTYPE_FLAG_BLOCKSOLID = 1 << 0,
+	ITEMTYPE_FLAG_BLOCKPROJECTILE = 1 << 1,
+	ITEMTYPE_FLAG_BLOCKPATHFIND = 1 << 2,
+	ITEMTYPE_FLAG_HASHEIGHT = 1 << 3,
+	ITEMTYPE_FLAG_MOVEABLE = 1 << 4,
+	ITEMTYPE_FLAG_PICKUPABLE = 1 << 5,
+	ITEMTYPE_FLAG_ALLOWPICKUPABLE = 1 << 6,
+	ITEMTYPE_FLAG_STACKABLE = 1 << 7,
+	ITEMTYPE_FLAG_ALWAYSONTOP = 1 << 8,
+	ITEMTYPE_FLAG_VERTICAL = 1 << 9,
+	ITEMTYPE_FLAG_HORIZONTAL = 1 << 10,
+	ITEMTYPE_FLAG_HANGABLE = 1 << 11,
+	ITEMTYPE_FLAG_USEABLE = 1 << 12,
+	ITEMTYPE_FLAG_LOOKTHROUGH = 1 << 13,
+	ITEMTYPE_FLAG_WALKSTACK = 1 << 14,
+	ITEMTYPE_FLAG_GROUND = 1 << 15,
+	ITEMTYPE_FLAG_SPLASH = 1 << 16,
+	ITEMTYPE_FLAG_CONTAINER = 1 << 17,
+	ITEMTYPE_FLAG_MAGICFIELD = 1 << 18,
+	ITEMTYPE_FLAG_TELEPORT = 1 << 19,
+	ITEMTYPE_FLAG_BED = 1 << 20,
+};
+
+// Compact copy of the ItemType fields used by the tile, stacking and
+// pathfinding code, four entries per cache line. The full ItemType keeps
+// the names, descriptions and abilities that are only needed when looking,
+// trading or equipping.
+struct alignas(16) ItemTypeHot {
+	bool hasFlag(uint32_t flag) const {
+		return (flags & flag) != 0;
+	}
+
+	uint32_t flags = 0;
+	uint32_t weight = 0;
+	uint16_t speed = 0;
+	uint8_t alwaysOnTopOrder = 0;
+	uint8_t floorChange = 0;
+};
+
 class ConditionDamage;
 
 class ItemType
@@ -404,6 +444,13 @@ class Items
 		ItemType& getItemType(size_t id);
 		const ItemType& getItemIdByClientId(uint16_t spriteId) const;
 
+		const ItemTypeHot& getHotType(size_t id) const {
+			if (id < hotItems.size()) {
+				return hotItems[id];
+			}
+			return hotItems.front();
+		}
+
 		uint16_t getItemIdByName(const std::string& name);
 
 		uint32_t majorVersion = 0;
@@ -414,6 +461,7 @@ class Items
 		void parseItemNode(const pugi::xml_node& itemNode, uint16_t id);
 
 		void buildInventoryList();
+		void buildHotList();
 		const InventoryVector& getInventory() const {
 			return inventory;
 		}
@@ -427,6 +475,7 @@ class Items
 	private:
 		std::map<uint16_t, uint16_t> reverseItemMap;
 		std::vector<ItemType> items;
+		std::vector<ItemTypeHot> hotItems;
 		InventoryVector inventory;
 };
 #endif
@@ -0,0 +1,211 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "luachunkcache.h"
+#include "configmanager.h"
+#include "luascript.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+LuaChunkCache g_luaChunkCache;
+
+extern ConfigManager g_config;
+
+namespace {
+
+const std::string CACHE_DIRECTORY = "data/cache/lua";
+const std::string CACHE_MAGIC = "TFSLUAC1";
+
+// bytecode only loads into the interpreter build that dumped it
+#ifdef LUAJIT_VERSION
+const std::string CACHE_INTERPRETER = LUAJIT_VERSION;
+#else
+const std::string CACHE_INTERPRETER = LUA_RELEASE;
+#endif
+
+// FNV-1a, stable across builds unlike std::hash
+uint64_t hashContents(const char* data, size_t size)
+{
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= static_cast<uint8_t>(data[i]);
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+std::string toHex(uint64_t value)
+{
+	std::ostringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << value;
+	return ss.str();
+}
+
+int writeChunk(lua_State*, const void* data, size_t size, void* userdata)
+{
+	static_cast<std::string*>(userdata)->append(static_cast<const char*>(data), size);
+	return 0;
+}
+
+std::string dumpChunk(lua_State* L)
+{
+	std::string bytecode;
+#if LUA_VERSION_NUM >= 503
+	lua_dump(L, writeChunk, &bytecode, 0);
+#else
+	lua_dump(L, writeChunk, &bytecode);
+#endif
+	return bytecode;
+}
+
+int loadChunk(lua_State* L, const std::string& chunk, const std::string& fileName)
+{
+	return luaL_loadbuffer(L, chunk.data(), chunk.size(), ('@' + fileName).c_str());
+}
+
+}
+
+int LuaChunkCache::load(lua_State* L, const std::string& fileName)
+{
+	namespace fs = boost::filesystem;
+
+	boost::system::error_code ec;
+	std::time_t modified = fs::last_write_time(fileName, ec);
+	uintmax_t size = ec ? 0 : fs::file_size(fileName, ec);
+	if (ec) {
+		// let the regular loader produce the error message
+		return luaL_loadfile(L, fileName.c_str());
+	}
+
+	// an unchanged file is not even read, unless it was modified within the
+	// second it was last checked in, which the timestamp can not tell apart
+	auto it = entries.find(fileName);
+	if (it != entries.end()) {
+		const Entry& entry = it->second;
+		if (entry.modified == modified && entry.size == size && modified < entry.checked && !entry.bytecode.empty()) {
+			if (loadChunk(L, entry.bytecode, fileName) == 0) {
+				++cachedCount;
+				return 0;
+			}
+			lua_pop(L, 1);
+		}
+	}
+
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file.is_open()) {
+		return luaL_loadfile(L, fileName.c_str());
+	}
+
+	std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+
+	Entry& entry = entries[fileName];
+	entry.modified = modified;
+	entry.checked = std::time(nullptr);
+	entry.size = size;
+
+	uint64_t hash = hashContents(source.data(), source.size());
+	if (entry.hash != hash || entry.bytecode.empty()) {
+		entry.hash = hash;
+		entry.bytecode.clear();
+		if (g_config.getBoolean(ConfigManager::LUA_BYTECODE_CACHE)) {
+			readCacheFile(fileName, hash, entry.bytecode);
+		}
+	}
+
+	if (!entry.bytecode.empty()) {
+		if (loadChunk(L, entry.bytecode, fileName) == 0) {
+			++cachedCount;
+			return 0;
+		}
+
+		// written by another interpreter build, compile it again
+		lua_pop(L, 1);
+		entry.bytecode.clear();
+	}
+
+	// luaL_loadfile skips a leading UTF-8 BOM and #! line, keep the line
+	// numbers by leaving the line break in place
+	size_t start = source.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+	if (source.compare(start, 1, "#") == 0) {
+		start = std::min(source.find('\n', start), source.size());
+	}
+
+	int ret = luaL_loadbuffer(L, source.data() + start, source.size() - start, ('@' + fileName).c_str());
+	if (ret != 0) {
+		entries.erase(fileName);
+		return ret;
+	}
+
+	++compiledCount;
+	entry.bytecode = dumpChunk(L);
+	if (g_config.getBoolean(ConfigManager::LUA_BYTECODE_CACHE)) {
+		writeCacheFile(fileName, hash, entry.bytecode);
+	}
+	return 0;
+}
+
+void LuaChunkCache::clear()
+{
+	entries.clear();
+}
+
+bool LuaChunkCache::readCacheFile(const std::string& fileName, uint64_t hash, std::string& bytecode)
+{
+	std::ifstream file(CACHE_DIRECTORY + '/' + toHex(hashContents(fileName.data(), fileName.size())) + ".luac", std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	// header: magic, interpreter and source hash, one per line
+	std::string magic, interpreter, sourceHash;
+	if (!std::getline(file, magic) || !std::getline(file, interpreter) || !std::getline(file, sourceHash)) {
+		return false;
+	}
+
+	if (magic != CACHE_MAGIC || interpreter != CACHE_INTERPRETER || sourceHash != toHex(hash)) {
+		return false;
+	}
+
+	bytecode.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return !bytecode.empty();
+}
+
+void LuaChunkCache::writeCacheFile(const std::string& fileName, uint64_t hash, const std::string& bytecode)
+{
+	namespace fs = boost::filesystem;
+
+	boost::system::error_code ec;
+	fs::create_directories(CACHE_DIRECTORY, ec);
+	if (ec) {
+		std::cout << "[Warning - LuaChunkCache::writeCacheFile] Can not create " << CACHE_DIRECTORY << ": " << ec.message() << std::endl;
+		return;
+	}
+
+	std::ofstream file(CACHE_DIRECTORY + '/' + toHex(hashContents(fileName.data(), fileName.size())) + ".luac", std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return;
+	}
+
+	file << CACHE_MAGIC << '\n' << CACHE_INTERPRETER << '\n' << toHex(hash) << '\n';
+	file.write(bytecode.data(), bytecode.size());
+}
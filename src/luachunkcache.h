@@ -0,0 +1,71 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_LUACHUNKCACHE_H_D38E1966ABCA4854A127B415CE4C71A9
+#define FS_LUACHUNKCACHE_H_D38E1966ABCA4854A127B415CE4C71A9
+
+struct lua_State;
+
+// Keeps the compiled bytecode of every script file loaded through
+// LuaScriptInterface::loadFile, so a reload only compiles the files that
+// changed. With luaBytecodeCache enabled the bytecode is also kept on disk
+// and reused across restarts.
+class LuaChunkCache
+{
+	public:
+		LuaChunkCache() = default;
+
+		// non-copyable
+		LuaChunkCache(const LuaChunkCache&) = delete;
+		LuaChunkCache& operator=(const LuaChunkCache&) = delete;
+
+		// pushes the chunk of fileName like luaL_loadfile does, returns
+		// its status and leaves the error message on the stack on failure
+		int load(lua_State* L, const std::string& fileName);
+
+		void clear();
+
+		uint64_t getCompiledCount() const {
+			return compiledCount;
+		}
+		uint64_t getCachedCount() const {
+			return cachedCount;
+		}
+
+	private:
+		struct Entry {
+			std::time_t modified = 0;
+			std::time_t checked = 0;
+			uintmax_t size = 0;
+			uint64_t hash = 0;
+			std::string bytecode;
+		};
+
+		static bool readCacheFile(const std::string& fileName, uint64_t hash, std::string& bytecode);
+		static void writeCacheFile(const std::string& fileName, uint64_t hash, const std::string& bytecode);
+
+		std::unordered_map<std::string, Entry> entries;
+
+		uint64_t compiledCount = 0;
+		uint64_t cachedCount = 0;
+};
+
+extern LuaChunkCache g_luaChunkCache;
+
+#endif
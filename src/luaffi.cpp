@@ -0,0 +1,326 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "luaffi.h"
+
+#ifdef LUAJIT_VERSION
+
+#include "monster.h"
+#include "player.h"
+
+// luajit.lua declares the same layout as struct tfs_position
+static_assert(offsetof(LuaPosition, position) == 0 && offsetof(Position, x) == 0 && offsetof(Position, y) == 2 &&
+	offsetof(Position, z) == 4 && offsetof(LuaPosition, stackpos) == 8 && sizeof(LuaPosition) == 12, "struct tfs_position layout mismatch");
+
+int32_t tfs_ffi_abi_version()
+{
+	return TFS_FFI_ABI_VERSION;
+}
+
+// Creature
+uint32_t tfs_creature_get_id(const Creature* creature)
+{
+	return creature->getID();
+}
+
+const char* tfs_creature_get_name(const Creature* creature)
+{
+	return creature->getName().c_str();
+}
+
+int32_t tfs_creature_get_health(const Creature* creature)
+{
+	return creature->getHealth();
+}
+
+int32_t tfs_creature_get_max_health(const Creature* creature)
+{
+	return creature->getMaxHealth();
+}
+
+int32_t tfs_creature_get_speed(const Creature* creature)
+{
+	return creature->getSpeed();
+}
+
+uint32_t tfs_creature_get_base_speed(const Creature* creature)
+{
+	return creature->getBaseSpeed();
+}
+
+uint8_t tfs_creature_get_direction(const Creature* creature)
+{
+	return creature->getDirection();
+}
+
+uint8_t tfs_creature_get_skull(const Creature* creature)
+{
+	return creature->getSkull();
+}
+
+bool tfs_creature_is_removed(const Creature* creature)
+{
+	return creature->isRemoved();
+}
+
+bool tfs_creature_is_in_ghost_mode(const Creature* creature)
+{
+	return creature->isInGhostMode();
+}
+
+bool tfs_creature_is_health_hidden(const Creature* creature)
+{
+	return creature->isHealthHidden();
+}
+
+void tfs_creature_get_position(const Creature* creature, LuaPosition* position)
+{
+	position->position = creature->getPosition();
+	position->stackpos = 0;
+}
+
+// Item
+uint16_t tfs_item_get_id(const Item* item)
+{
+	return item->getID();
+}
+
+uint16_t tfs_item_get_count(const Item* item)
+{
+	return item->getItemCount();
+}
+
+uint16_t tfs_item_get_charges(const Item* item)
+{
+	return item->getCharges();
+}
+
+uint16_t tfs_item_get_fluid_type(const Item* item)
+{
+	return item->getFluidType();
+}
+
+uint16_t tfs_item_get_sub_type(const Item* item)
+{
+	return item->getSubType();
+}
+
+uint16_t tfs_item_get_action_id(const Item* item)
+{
+	return item->getActionId();
+}
+
+uint32_t tfs_item_get_unique_id(Item* item)
+{
+	uint32_t uniqueId = item->getUniqueId();
+	if (uniqueId == 0) {
+		uniqueId = LuaScriptInterface::getScriptEnv()->addThing(item);
+	}
+	return uniqueId;
+}
+
+uint32_t tfs_item_get_weight(const Item* item)
+{
+	return item->getWeight();
+}
+
+bool tfs_item_has_attribute(const Item* item, int32_t attribute)
+{
+	return item->hasAttribute(static_cast<itemAttrTypes>(attribute));
+}
+
+void tfs_item_get_position(const Item* item, LuaPosition* position)
+{
+	position->position = item->getPosition();
+	position->stackpos = 0;
+}
+
+// Player
+uint32_t tfs_player_get_guid(const Player* player)
+{
+	return player->getGUID();
+}
+
+uint32_t tfs_player_get_ip(const Player* player)
+{
+	return player->getIP();
+}
+
+double tfs_player_get_last_login_saved(const Player* player)
+{
+	return player->getLastLoginSaved();
+}
+
+uint32_t tfs_player_get_account_id(const Player* player)
+{
+	return player->getAccount();
+}
+
+int32_t tfs_player_get_account_type(const Player* player)
+{
+	return player->getAccountType();
+}
+
+uint32_t tfs_player_get_level(const Player* player)
+{
+	return player->getLevel();
+}
+
+double tfs_player_get_experience(const Player* player)
+{
+	return player->getExperience();
+}
+
+uint32_t tfs_player_get_magic_level(const Player* player)
+{
+	return player->getMagicLevel();
+}
+
+uint32_t tfs_player_get_base_magic_level(const Player* player)
+{
+	return player->getBaseMagicLevel();
+}
+
+uint32_t tfs_player_get_mana(const Player* player)
+{
+	return player->getMana();
+}
+
+uint32_t tfs_player_get_max_mana(const Player* player)
+{
+	return player->getMaxMana();
+}
+
+double tfs_player_get_mana_spent(const Player* player)
+{
+	return player->getSpentMana();
+}
+
+uint8_t tfs_player_get_soul(const Player* player)
+{
+	return player->getSoul();
+}
+
+int32_t tfs_player_get_max_soul(const Player* player)
+{
+	const Vocation* vocation = player->getVocation();
+	if (!vocation) {
+		return -1;
+	}
+	return vocation->getSoulMax();
+}
+
+uint32_t tfs_player_get_capacity(const Player* player)
+{
+	return player->getCapacity();
+}
+
+uint32_t tfs_player_get_free_capacity(const Player* player)
+{
+	return player->getFreeCapacity();
+}
+
+int32_t tfs_player_get_skill_level(const Player* player, int32_t skill)
+{
+	if (skill < SKILL_FIRST || skill > SKILL_LAST) {
+		return -1;
+	}
+	return player->getBaseSkill(skill);
+}
+
+int32_t tfs_player_get_effective_skill_level(const Player* player, int32_t skill)
+{
+	if (skill < SKILL_FIRST || skill > SKILL_LAST) {
+		return -1;
+	}
+	return player->getSkillLevel(skill);
+}
+
+int32_t tfs_player_get_skill_percent(const Player* player, int32_t skill)
+{
+	if (skill < SKILL_FIRST || skill > SKILL_LAST) {
+		return -1;
+	}
+	return player->getSkillPercent(skill);
+}
+
+uint16_t tfs_player_get_stamina(const Player* player)
+{
+	return player->getStaminaMinutes();
+}
+
+int32_t tfs_player_get_premium_days(const Player* player)
+{
+	return player->getPremiumDays();
+}
+
+int32_t tfs_player_get_sex(const Player* player)
+{
+	return player->getSex();
+}
+
+double tfs_player_get_skull_time(const Player* player)
+{
+	return player->getSkullTicks();
+}
+
+double tfs_player_get_bank_balance(const Player* player)
+{
+	return player->getBankBalance();
+}
+
+double tfs_player_get_money(const Player* player)
+{
+	return player->getMoney();
+}
+
+bool tfs_player_is_pz_locked(const Player* player)
+{
+	return player->isPzLocked();
+}
+
+uint32_t tfs_player_get_item_count(const Player* player, uint16_t itemId, int32_t subType)
+{
+	const Cylinder* cylinder = player;
+	return cylinder->getItemTypeCount(itemId, subType);
+}
+
+int32_t tfs_player_get_storage_value(const Player* player, uint32_t key)
+{
+	int32_t value;
+	if (!player->getStorageValue(key, value)) {
+		return -1;
+	}
+	return value;
+}
+
+// Monster
+uint32_t tfs_monster_get_friend_count(const Monster* monster)
+{
+	return monster->getFriendList().size();
+}
+
+uint32_t tfs_monster_get_target_count(const Monster* monster)
+{
+	return monster->getTargetList().size();
+}
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_LUAFFI_H_B7DCE82785A04C69B89363507848C84E
+#define FS_LUAFFI_H_B7DCE82785A04C69B89363507848C84E
+
+#include "luascript.h"
+
+// Plain C entry points for the hottest userdata accessors, bound through
+// the LuaJIT FFI by data/lib/core/luajit.lua. A call through a lua_CFunction
+// aborts the trace it appears in, while an FFI call is compiled inline.
+//
+// Every function takes the object pointer stored in the userdata payload,
+// the Lua side checks it for NULL before calling. Keep the declarations in
+// sync with the ffi.cdef block of luajit.lua and bump TFS_FFI_ABI_VERSION
+// whenever a signature changes.
+#ifdef LUAJIT_VERSION
+
+#if defined(_WIN32)
+	#define TFS_FFI_EXPORT extern "C" __declspec(dllexport)
+#else
+	#define TFS_FFI_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+#define TFS_FFI_ABI_VERSION 4
+
+class Creature;
+class Item;
+class Monster;
+class Player;
+
+TFS_FFI_EXPORT int32_t tfs_ffi_abi_version();
+
+// Creature
+TFS_FFI_EXPORT uint32_t tfs_creature_get_id(const Creature* creature);
+TFS_FFI_EXPORT const char* tfs_creature_get_name(const Creature* creature);
+TFS_FFI_EXPORT int32_t tfs_creature_get_health(const Creature* creature);
+TFS_FFI_EXPORT int32_t tfs_creature_get_max_health(const Creature* creature);
+TFS_FFI_EXPORT int32_t tfs_creature_get_speed(const Creature* creature);
+TFS_FFI_EXPORT uint32_t tfs_creature_get_base_speed(const Creature* creature);
+TFS_FFI_EXPORT uint8_t tfs_creature_get_direction(const Creature* creature);
+TFS_FFI_EXPORT uint8_t tfs_creature_get_skull(const Creature* creature);
+TFS_FFI_EXPORT bool tfs_creature_is_removed(const Creature* creature);
+TFS_FFI_EXPORT bool tfs_creature_is_in_ghost_mode(const Creature* creature);
+TFS_FFI_EXPORT bool tfs_creature_is_health_hidden(const Creature* creature);
+TFS_FFI_EXPORT void tfs_creature_get_position(const Creature* creature, LuaPosition* position);
+
+// Item
+TFS_FFI_EXPORT uint16_t tfs_item_get_id(const Item* item);
+TFS_FFI_EXPORT uint16_t tfs_item_get_count(const Item* item);
+TFS_FFI_EXPORT uint16_t tfs_item_get_charges(const Item* item);
+TFS_FFI_EXPORT uint16_t tfs_item_get_fluid_type(const Item* item);
+TFS_FFI_EXPORT uint16_t tfs_item_get_sub_type(const Item* item);
+TFS_FFI_EXPORT uint16_t tfs_item_get_action_id(const Item* item);
+TFS_FFI_EXPORT uint32_t tfs_item_get_unique_id(Item* item);
+TFS_FFI_EXPORT uint32_t tfs_item_get_weight(const Item* item);
+TFS_FFI_EXPORT bool tfs_item_has_attribute(const Item* item, int32_t attribute);
+TFS_FFI_EXPORT void tfs_item_get_position(const Item* item, LuaPosition* position);
+
+// Player
+TFS_FFI_EXPORT uint32_t tfs_player_get_guid(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_ip(const Player* player);
+TFS_FFI_EXPORT double tfs_player_get_last_login_saved(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_account_id(const Player* player);
+TFS_FFI_EXPORT int32_t tfs_player_get_account_type(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_level(const Player* player);
+TFS_FFI_EXPORT double tfs_player_get_experience(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_magic_level(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_base_magic_level(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_mana(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_max_mana(const Player* player);
+TFS_FFI_EXPORT double tfs_player_get_mana_spent(const Player* player);
+TFS_FFI_EXPORT uint8_t tfs_player_get_soul(const Player* player);
+TFS_FFI_EXPORT int32_t tfs_player_get_max_soul(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_capacity(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_free_capacity(const Player* player);
+TFS_FFI_EXPORT int32_t tfs_player_get_skill_level(const Player* player, int32_t skill);
+TFS_FFI_EXPORT int32_t tfs_player_get_effective_skill_level(const Player* player, int32_t skill);
+TFS_FFI_EXPORT int32_t tfs_player_get_skill_percent(const Player* player, int32_t skill);
+TFS_FFI_EXPORT uint16_t tfs_player_get_stamina(const Player* player);
+TFS_FFI_EXPORT int32_t tfs_player_get_premium_days(const Player* player);
+TFS_FFI_EXPORT int32_t tfs_player_get_sex(const Player* player);
+TFS_FFI_EXPORT double tfs_player_get_skull_time(const Player* player);
+TFS_FFI_EXPORT double tfs_player_get_bank_balance(const Player* player);
+TFS_FFI_EXPORT double tfs_player_get_money(const Player* player);
+TFS_FFI_EXPORT bool tfs_player_is_pz_locked(const Player* player);
+TFS_FFI_EXPORT uint32_t tfs_player_get_item_count(const Player* player, uint16_t itemId, int32_t subType);
+TFS_FFI_EXPORT int32_t tfs_player_get_storage_value(const Player* player, uint32_t key);
+
+// Monster
+TFS_FFI_EXPORT uint32_t tfs_monster_get_friend_count(const Monster* monster);
+TFS_FFI_EXPORT uint32_t tfs_monster_get_target_count(const Monster* monster);
+
+#endif
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "luaprofiler.h"
+#include "luascript.h"
+
+#include <fstream>
+
+LuaProfiler g_luaProfiler;
+
+extern LuaEnvironment g_luaEnvironment;
+
+namespace {
+
+std::string getFrameName(const lua_Debug& frame)
+{
+	std::ostringstream ss;
+	if (strcmp(frame.what, "C") == 0) {
+		ss << (frame.name ? frame.name : "?") << " [C]";
+	} else if (strcmp(frame.what, "main") == 0) {
+		ss << frame.short_src << " (main chunk)";
+	} else {
+		ss << frame.short_src << ':' << frame.linedefined;
+		if (frame.name) {
+			ss << " (" << frame.name << ')';
+		}
+	}
+
+	// ';' separates frames in the folded format
+	std::string name = ss.str();
+	std::replace(name.begin(), name.end(), ';', ':');
+	return name;
+}
+
+}
+
+void LuaProfiler::start(uint32_t sampleInterval /*= 0*/)
+{
+	enabled = true;
+	this->sampleInterval = sampleInterval;
+	attach(g_luaEnvironment.getLuaState());
+}
+
+void LuaProfiler::stop()
+{
+	enabled = false;
+	sampleInterval = 0;
+	attach(g_luaEnvironment.getLuaState());
+}
+
+void LuaProfiler::reset()
+{
+	callStats.clear();
+	stackSamples.clear();
+}
+
+void LuaProfiler::attach(lua_State* L)
+{
+	pendingInstructions = 0;
+	LuaScriptInterface::updateHook(L);
+}
+
+void LuaProfiler::countInstructions(lua_State* L, uint32_t count)
+{
+	pendingInstructions += count;
+	if (pendingInstructions >= sampleInterval) {
+		pendingInstructions = 0;
+		sample(L);
+	}
+}
+
+void LuaProfiler::recordCall(const ScriptEnvironment& env, std::chrono::nanoseconds elapsed)
+{
+	int32_t scriptId, callbackId;
+	bool timerEvent;
+	LuaScriptInterface* scriptInterface;
+	env.getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+
+	CallStats& stats = callStats[{scriptInterface, scriptId, callbackId}];
+	if (stats.calls++ == 0) {
+		if (scriptInterface) {
+			stats.interfaceName = scriptInterface->getInterfaceName();
+			stats.scriptFile = scriptInterface->getFileById(scriptId);
+		} else {
+			stats.interfaceName = "(Unknown interface)";
+		}
+
+		if (timerEvent) {
+			stats.scriptFile += " (timer event)";
+		}
+		stats.callbackId = callbackId;
+	}
+
+	stats.totalTime += elapsed;
+	stats.maxTime = std::max(stats.maxTime, elapsed);
+}
+
+void LuaProfiler::sample(lua_State* L)
+{
+	std::vector<std::string> frames;
+
+	lua_Debug frame;
+	for (int level = 0; lua_getstack(L, level, &frame) != 0; ++level) {
+		lua_getinfo(L, "Sn", &frame);
+		frames.push_back(getFrameName(frame));
+	}
+
+	// the folded format lists the outermost frame first
+	std::ostringstream ss;
+	if (LuaScriptInterface::hasScriptEnv()) {
+		const LuaScriptInterface* scriptInterface = LuaScriptInterface::getScriptEnv()->getScriptInterface();
+		ss << (scriptInterface ? scriptInterface->getInterfaceName() : "(Unknown interface)");
+	} else {
+		ss << "(Loading)";
+	}
+
+	for (auto it = frames.rbegin(), end = frames.rend(); it != end; ++it) {
+		ss << ';' << *it;
+	}
+	++stackSamples[ss.str()];
+}
+
+bool LuaProfiler::writeReport(const std::string& fileName) const
+{
+	std::ofstream file(fileName);
+	if (!file.is_open()) {
+		std::cout << "[Warning - LuaProfiler::writeReport] Can not open " << fileName << '.' << std::endl;
+		return false;
+	}
+
+	std::vector<const CallStats*> entries;
+	entries.reserve(callStats.size());
+	for (const auto& it : callStats) {
+		entries.push_back(&it.second);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const CallStats* lhs, const CallStats* rhs) {
+		return lhs->totalTime > rhs->totalTime;
+	});
+
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	file << "interface\tscript\tcallback\tcalls\ttotal (us)\taverage (us)\tmax (us)\n";
+	for (const CallStats* stats : entries) {
+		const int64_t totalTime = duration_cast<microseconds>(stats->totalTime).count();
+		file << stats->interfaceName << '\t' << stats->scriptFile << '\t' << stats->callbackId << '\t' << stats->calls << '\t'
+		     << totalTime << '\t' << totalTime / static_cast<int64_t>(stats->calls) << '\t'
+		     << duration_cast<microseconds>(stats->maxTime).count() << '\n';
+	}
+	return true;
+}
+
+bool LuaProfiler::writeFoldedStacks(const std::string& fileName) const
+{
+	std::ofstream file(fileName);
+	if (!file.is_open()) {
+		std::cout << "[Warning - LuaProfiler::writeFoldedStacks] Can not open " << fileName << '.' << std::endl;
+		return false;
+	}
+
+	for (const auto& it : stackSamples) {
+		file << it.first << ' ' << it.second << '\n';
+	}
+	return true;
+}
@@ -0,0 +1,101 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_LUAPROFILER_H_DAEEC2EE259F4164A4BCF07AD3A9EDED
+#define FS_LUAPROFILER_H_DAEEC2EE259F4164A4BCF07AD3A9EDED
+
+struct lua_State;
+
+class LuaScriptInterface;
+class ScriptEnvironment;
+
+class LuaProfiler
+{
+	public:
+		LuaProfiler() = default;
+
+		// non-copyable
+		LuaProfiler(const LuaProfiler&) = delete;
+		LuaProfiler& operator=(const LuaProfiler&) = delete;
+
+		// sampleInterval is the number of Lua instructions between two stack
+		// samples, 0 only records call times
+		void start(uint32_t sampleInterval = 0);
+		void stop();
+		void reset();
+
+		bool isEnabled() const {
+			return enabled;
+		}
+
+		uint32_t getSampleInterval() const {
+			return enabled ? sampleInterval : 0;
+		}
+
+		// installs the sampling hook on a (re)created Lua state
+		void attach(lua_State* L);
+
+		// called from the shared count hook, takes a stack sample every
+		// sampleInterval instructions
+		void countInstructions(lua_State* L, uint32_t count);
+
+		void recordCall(const ScriptEnvironment& env, std::chrono::nanoseconds elapsed);
+
+		bool writeReport(const std::string& fileName) const;
+		bool writeFoldedStacks(const std::string& fileName) const;
+
+	private:
+		void sample(lua_State* L);
+
+		struct CallKey {
+			const LuaScriptInterface* scriptInterface;
+			int32_t scriptId;
+			int32_t callbackId;
+
+			bool operator==(const CallKey& other) const {
+				return scriptInterface == other.scriptInterface && scriptId == other.scriptId && callbackId == other.callbackId;
+			}
+		};
+
+		struct CallKeyHash {
+			size_t operator()(const CallKey& key) const {
+				return std::hash<const void*>()(key.scriptInterface) ^ (static_cast<size_t>(key.scriptId) << 16) ^ static_cast<size_t>(key.callbackId);
+			}
+		};
+
+		struct CallStats {
+			std::string interfaceName;
+			std::string scriptFile;
+			int32_t callbackId = 0;
+			uint64_t calls = 0;
+			std::chrono::nanoseconds totalTime {0};
+			std::chrono::nanoseconds maxTime {0};
+		};
+
+		std::unordered_map<CallKey, CallStats, CallKeyHash> callStats;
+		std::unordered_map<std::string, uint64_t> stackSamples;
+
+		uint32_t sampleInterval = 0;
+		uint32_t pendingInstructions = 0;
+		bool enabled = false;
+};
+
+extern LuaProfiler g_luaProfiler;
+
+#endif
@@ -39,6 +39,9 @@
 #include "globalevent.h"
 #include "script.h"
 #include "weapons.h"
+#include "pool.h"
+#include "luaprofiler.h"
+#include "luachunkcache.h"
 
 extern Chat* g_chat;
 extern Game g_game;
@@ -55,6 +58,7 @@ extern Scripts* g_scripts;
 extern Weapons* g_weapons;
 
 ScriptEnvironment::DBResultMap ScriptEnvironment::tempResults;
+std::map<uint32_t, ScriptEnvironment::PinnedResult> ScriptEnvironment::pinnedResults;
 uint32_t ScriptEnvironment::lastResultId = 0;
 
 std::multimap<ScriptEnvironment*, Item*> ScriptEnvironment::tempItems;
@@ -228,7 +232,7 @@ bool ScriptEnvironment::removeResult(uint32_t id)
 {
 	auto it = tempResults.find(id);
 	if (it == tempResults.end()) {
-		return false;
+		return pinnedResults.erase(id) != 0;
 	}
 
 	tempResults.erase(it);
@@ -239,11 +243,32 @@ DBResult_ptr ScriptEnvironment::getResultByID(uint32_t id)
 {
 	auto it = tempResults.find(id);
 	if (it == tempResults.end()) {
-		return nullptr;
+		auto pinnedIt = pinnedResults.find(id);
+		if (pinnedIt == pinnedResults.end()) {
+			return nullptr;
+		}
+		return pinnedIt->second.result;
 	}
 	return it->second;
 }
 
+uint32_t ScriptEnvironment::addPinnedResult(DBResult_ptr res, const lua_State* owner)
+{
+	pinnedResults.emplace(++lastResultId, PinnedResult{owner, std::move(res)});
+	return lastResultId;
+}
+
+void ScriptEnvironment::releasePinnedResults(const lua_State* owner)
+{
+	for (auto it = pinnedResults.begin(); it != pinnedResults.end();) {
+		if (it->second.owner == owner) {
+			it = pinnedResults.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
 std::string LuaScriptInterface::getErrorDesc(ErrorCode_t code)
 {
 	switch (code) {
@@ -267,7 +292,63 @@ std::string LuaScriptInterface::getErrorDesc(ErrorCode_t code)
 ScriptEnvironment LuaScriptInterface::scriptEnv[16];
 int32_t LuaScriptInterface::scriptEnvIndex = -1;
 
-LuaScriptInterface::LuaScriptInterface(std::string interfaceName) : interfaceName(std::move(interfaceName))
+const LuaScriptInterface* LuaScriptInterface::runningInterface = nullptr;
+std::atomic<int32_t> LuaScriptInterface::runningInterfaceId {-1};
+std::atomic<int32_t> LuaScriptInterface::runningScriptId {-1};
+std::atomic<bool> LuaScriptInterface::stackDumpRequested {false};
+
+namespace {
+
+// instructions between two checks of the script budget deadline
+constexpr uint32_t SCRIPT_BUDGET_CHECK_INSTRUCTIONS = 10000;
+// instructions between two checks for a watchdog stack dump request
+constexpr uint32_t WATCHDOG_CHECK_INSTRUCTIONS = 1000000;
+
+// state of the outermost running call, only touched by the dispatcher thread
+uint32_t callDepth = 0;
+int64_t callBudget = 0;
+std::chrono::steady_clock::time_point callDeadline;
+uint32_t hookCount = 0;
+// state of the innermost running call, only touched on the dispatcher
+lua_State* callState = nullptr;
+
+bool isWatchdogEnabled()
+{
+	return g_config.getNumber(ConfigManager::DISPATCHER_WATCHDOG_TIME) > 0;
+}
+
+// Names of every interface created so far, an interface may be gone by the
+// time the watchdog reports the call that ran in it.
+struct InterfaceNames {
+	std::mutex lock;
+	std::vector<std::string> names;
+};
+
+InterfaceNames& getInterfaceNames()
+{
+	// g_luaEnvironment registers its name during static initialization
+	static InterfaceNames interfaceNames;
+	return interfaceNames;
+}
+
+int32_t getInterfaceId(const std::string& interfaceName)
+{
+	InterfaceNames& interfaceNames = getInterfaceNames();
+	std::lock_guard<std::mutex> lockGuard(interfaceNames.lock);
+
+	auto it = std::find(interfaceNames.names.begin(), interfaceNames.names.end(), interfaceName);
+	if (it != interfaceNames.names.end()) {
+		return std::distance(interfaceNames.names.begin(), it);
+	}
+
+	interfaceNames.names.push_back(interfaceName);
+	return interfaceNames.names.size() - 1;
+}
+
+}
+
+LuaScriptInterface::LuaScriptInterface(std::string interfaceName) :
+	interfaceName(std::move(interfaceName)), interfaceId(getInterfaceId(this->interfaceName))
 {
 	if (!g_luaEnvironment.getLuaState()) {
 		g_luaEnvironment.initState();
@@ -300,10 +381,204 @@ int LuaScriptInterface::protectedCall(lua_State* L, int nargs, int nresults)
 	return ret;
 }
 
+int LuaScriptInterface::instrumentedCall(lua_State* L, int nargs, int nresults)
+{
+	if (!hasScriptEnv()) {
+		return protectedCall(L, nargs, nresults);
+	}
+
+	return instrumented(L, [L, nargs, nresults]() {
+		return protectedCall(L, nargs, nresults);
+	});
+}
+
+int LuaScriptInterface::instrumentedResume(lua_State* L, lua_State* thread, int nargs)
+{
+	auto resume = [L, thread, nargs]() {
+#if LUA_VERSION_NUM >= 504
+		int results;
+		return lua_resume(thread, L, nargs, &results);
+#elif LUA_VERSION_NUM >= 502
+		return lua_resume(thread, L, nargs);
+#else
+		static_cast<void>(L);
+		return lua_resume(thread, nargs);
+#endif
+	};
+
+	if (!hasScriptEnv()) {
+		return resume();
+	}
+	return instrumented(thread, resume);
+}
+
+template <typename Call>
+int LuaScriptInterface::instrumented(lua_State* L, Call call)
+{
+	ScriptEnvironment* env = getScriptEnv();
+
+	int32_t scriptId, callbackId;
+	bool timerEvent;
+	LuaScriptInterface* scriptInterface;
+	env->getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+
+	const LuaScriptInterface* previousInterface = runningInterface;
+	runningInterface = scriptInterface;
+	int32_t previousInterfaceId = runningInterfaceId.exchange(scriptInterface ? scriptInterface->interfaceId : -1, std::memory_order_relaxed);
+	int32_t previousScriptId = runningScriptId.exchange(scriptId, std::memory_order_relaxed);
+	lua_State* previousState = callState;
+	callState = L;
+
+	// the watchdog only raises stackDumpRequested, the count hook installed
+	// here while it is enabled picks the request up
+	const bool watchdogEnabled = isWatchdogEnabled();
+
+	// nested calls run on the budget of the outermost one
+	if (callDepth++ == 0) {
+		// drop a dump request that raced with the end of the previous call
+		stackDumpRequested.store(false);
+
+		callBudget = scriptInterface ? scriptInterface->getBudget() : g_config.getNumber(ConfigManager::SCRIPT_BUDGET);
+		if (callBudget > 0) {
+			callDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(callBudget);
+		}
+
+		if (callBudget > 0 || watchdogEnabled || g_luaProfiler.getSampleInterval() != 0) {
+			updateHook(L);
+		}
+	} else if (callBudget > 0 || watchdogEnabled || g_luaProfiler.getSampleInterval() != 0) {
+		// hooks are per coroutine, a nested call may run on another one
+		updateHook(L);
+	}
+
+	int ret;
+	if (g_luaProfiler.isEnabled()) {
+		const auto startTime = std::chrono::steady_clock::now();
+		ret = call();
+		g_luaProfiler.recordCall(*env, std::chrono::steady_clock::now() - startTime);
+	} else {
+		ret = call();
+	}
+
+	if (--callDepth == 0) {
+		// a dump requested after the script returned has nothing left to show
+		stackDumpRequested.store(false);
+		if (callBudget > 0 || watchdogEnabled) {
+			callBudget = 0;
+			updateHook(L);
+		}
+	} else if (L != previousState) {
+		// the outer call resumes on its own state, leave no hook behind here
+		lua_sethook(L, nullptr, 0, 0);
+	}
+
+	callState = previousState;
+	runningInterface = previousInterface;
+	runningInterfaceId.store(previousInterfaceId, std::memory_order_relaxed);
+	runningScriptId.store(previousScriptId, std::memory_order_relaxed);
+	return ret;
+}
+
+int64_t LuaScriptInterface::getBudget() const
+{
+	int64_t budget = g_config.getNumber(budgetConfig);
+	if (budget == 0 && budgetConfig != ConfigManager::SCRIPT_BUDGET) {
+		budget = g_config.getNumber(ConfigManager::SCRIPT_BUDGET);
+	}
+	return budget;
+}
+
+void LuaScriptInterface::updateHook(lua_State* L)
+{
+	if (!L) {
+		return;
+	}
+
+	uint32_t count = 0;
+	if (callDepth != 0) {
+		if (callBudget > 0) {
+			count = SCRIPT_BUDGET_CHECK_INSTRUCTIONS;
+		} else if (isWatchdogEnabled()) {
+			count = WATCHDOG_CHECK_INSTRUCTIONS;
+		}
+	}
+
+	uint32_t sampleInterval = g_luaProfiler.getSampleInterval();
+	if (sampleInterval != 0 && (count == 0 || sampleInterval < count)) {
+		count = sampleInterval;
+	}
+
+	hookCount = count;
+	if (count != 0) {
+		lua_sethook(L, executionHook, LUA_MASKCOUNT, count);
+	} else {
+		lua_sethook(L, nullptr, 0, 0);
+	}
+}
+
+std::string LuaScriptInterface::getRunningInterfaceName()
+{
+	int32_t interfaceId = runningInterfaceId.load(std::memory_order_relaxed);
+	if (interfaceId < 0) {
+		return std::string();
+	}
+
+	InterfaceNames& interfaceNames = getInterfaceNames();
+	std::lock_guard<std::mutex> lockGuard(interfaceNames.lock);
+	return interfaceNames.names[interfaceId];
+}
+
+void LuaScriptInterface::executionHook(lua_State* L, lua_Debug*)
+{
+	if (stackDumpRequested.exchange(false)) {
+		// the stalled call is over, this is an unrelated uninstrumented one
+		if (callDepth == 0) {
+			updateHook(L);
+			return;
+		}
+
+		std::cout << "[Warning - LuaScriptInterface::executionHook] Lua stack of the stalled call:" << std::endl;
+
+		lua_Debug frame;
+		for (int level = 0; lua_getstack(L, level, &frame) != 0; ++level) {
+			lua_getinfo(L, "Snl", &frame);
+			std::cout << "\t" << frame.short_src << ':' << frame.currentline;
+			if (frame.name) {
+				std::cout << " in " << frame.name;
+			}
+			std::cout << std::endl;
+		}
+
+		updateHook(L);
+		return;
+	}
+
+	if (g_luaProfiler.getSampleInterval() != 0) {
+		g_luaProfiler.countInstructions(L, hookCount);
+	}
+
+	if (callDepth == 0 || callBudget <= 0 || std::chrono::steady_clock::now() < callDeadline) {
+		return;
+	}
+
+	lua_Debug frame;
+	std::ostringstream location;
+	if (lua_getstack(L, 0, &frame) != 0 && lua_getinfo(L, "Sl", &frame) != 0) {
+		location << frame.short_src << ':' << frame.currentline;
+	} else {
+		location << "(unknown)";
+	}
+
+	const LuaScriptInterface* scriptInterface = runningInterface;
+	std::cout << "[Warning - LuaScriptInterface::executionHook] " << (scriptInterface ? scriptInterface->getInterfaceName() : "(Unknown interface)")
+		<< " script exceeded its budget of " << callBudget << " ms at " << location.str() << '.' << std::endl;
+	luaL_error(L, "script budget of %d ms exceeded", static_cast<int>(callBudget));
+}
+
 int32_t LuaScriptInterface::loadFile(const std::string& file, Npc* npc /* = nullptr*/)
 {
-	//loads file as a chunk at stack top
-	int ret = luaL_loadfile(luaState, file.c_str());
+	//loads file as a chunk at stack top, unchanged files reuse their bytecode
+	int ret = g_luaChunkCache.load(luaState, file);
 	if (ret != 0) {
 		lastLuaError = popString(luaState);
 		return -1;
@@ -542,7 +817,7 @@ bool LuaScriptInterface::callFunction(int params)
 {
 	bool result = false;
 	int size = lua_gettop(luaState);
-	if (protectedCall(luaState, params, 1) != 0) {
+	if (instrumentedCall(luaState, params, 1) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::getString(luaState, -1));
 	} else {
 		result = LuaScriptInterface::getBoolean(luaState, -1);
@@ -560,7 +835,7 @@ bool LuaScriptInterface::callFunction(int params)
 void LuaScriptInterface::callVoidFunction(int params)
 {
 	int size = lua_gettop(luaState);
-	if (protectedCall(luaState, params, 0) != 0) {
+	if (instrumentedCall(luaState, params, 0) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(luaState));
 	}
 
@@ -739,6 +1014,11 @@ std::string LuaScriptInterface::getString(lua_State* L, int32_t arg)
 
 Position LuaScriptInterface::getPosition(lua_State* L, int32_t arg, int32_t& stackpos)
 {
+	if (const LuaPosition* userdata = getPositionUserdata(L, arg)) {
+		stackpos = userdata->stackpos;
+		return userdata->position;
+	}
+
 	Position position;
 	position.x = getField<uint16_t>(L, arg, "x");
 	position.y = getField<uint16_t>(L, arg, "y");
@@ -757,6 +1037,10 @@ Position LuaScriptInterface::getPosition(lua_State* L, int32_t arg, int32_t& sta
 
 Position LuaScriptInterface::getPosition(lua_State* L, int32_t arg)
 {
+	if (const LuaPosition* userdata = getPositionUserdata(L, arg)) {
+		return userdata->position;
+	}
+
 	Position position;
 	position.x = getField<uint16_t>(L, arg, "x");
 	position.y = getField<uint16_t>(L, arg, "y");
@@ -894,6 +1178,14 @@ LuaDataType LuaScriptInterface::getUserdataType(lua_State* L, int32_t arg)
 	return type;
 }
 
+LuaPosition* LuaScriptInterface::getPositionUserdata(lua_State* L, int32_t arg)
+{
+	if (lua_type(L, arg) != LUA_TUSERDATA || getUserdataType(L, arg) != LuaData_Position) {
+		return nullptr;
+	}
+	return static_cast<LuaPosition*>(lua_touserdata(L, arg));
+}
+
 // Push
 void LuaScriptInterface::pushBoolean(lua_State* L, bool value)
 {
@@ -928,12 +1220,11 @@ void LuaScriptInterface::pushInstantSpell(lua_State* L, const InstantSpell& spel
 
 void LuaScriptInterface::pushPosition(lua_State* L, const Position& position, int32_t stackpos/* = 0*/)
 {
-	lua_createtable(L, 0, 4);
-
-	setField(L, "x", position.x);
-	setField(L, "y", position.y);
-	setField(L, "z", position.z);
-	setField(L, "stackpos", stackpos);
+	// a single small userdata instead of a table with a four slot hash part,
+	// x, y, z and stackpos are served by Position.__index and __newindex
+	LuaPosition* userdata = static_cast<LuaPosition*>(lua_newuserdata(L, sizeof(LuaPosition)));
+	userdata->position = position;
+	userdata->stackpos = stackpos;
 
 	setMetatable(L, -1, "Position");
 }
@@ -1686,6 +1977,8 @@ void LuaScriptInterface::registerFunctions()
 	registerEnum(TILESTATE_FLOORCHANGE_SOUTH_ALT)
 	registerEnum(TILESTATE_FLOORCHANGE_EAST_ALT)
 	registerEnum(TILESTATE_SUPPORTS_HANGABLE)
+	registerEnum(TILESTATE_BLOCKPROJECTILE)
+	registerEnum(TILESTATE_MOVEEVENT)
 
 	registerEnum(WEAPON_NONE)
 	registerEnum(WEAPON_SWORD)
@@ -1904,6 +2197,8 @@ void LuaScriptInterface::registerFunctions()
 	registerEnumIn("configKeys", ConfigManager::SERVER_SAVE_CLEAN_MAP)
 	registerEnumIn("configKeys", ConfigManager::SERVER_SAVE_CLOSE)
 	registerEnumIn("configKeys", ConfigManager::SERVER_SAVE_SHUTDOWN)
+	registerEnumIn("configKeys", ConfigManager::LUA_FFI_BINDINGS)
+	registerEnumIn("configKeys", ConfigManager::LUA_BYTECODE_CACHE)
 
 	registerEnumIn("configKeys", ConfigManager::MAP_NAME)
 	registerEnumIn("configKeys", ConfigManager::HOUSE_RENT_PERIOD)
@@ -1954,6 +2249,13 @@ void LuaScriptInterface::registerFunctions()
 	registerEnumIn("configKeys", ConfigManager::MAX_MARKET_OFFERS_AT_A_TIME_PER_PLAYER)
 	registerEnumIn("configKeys", ConfigManager::EXP_FROM_PLAYERS_LEVEL_RANGE)
 	registerEnumIn("configKeys", ConfigManager::MAX_PACKETS_PER_SECOND)
+	registerEnumIn("configKeys", ConfigManager::SCRIPT_BUDGET)
+	registerEnumIn("configKeys", ConfigManager::SCRIPT_BUDGET_ACTIONS)
+	registerEnumIn("configKeys", ConfigManager::SCRIPT_BUDGET_MOVEEVENTS)
+	registerEnumIn("configKeys", ConfigManager::SCRIPT_BUDGET_GLOBALEVENTS)
+	registerEnumIn("configKeys", ConfigManager::SCRIPT_BUDGET_NPC)
+	registerEnumIn("configKeys", ConfigManager::DISPATCHER_WATCHDOG_TIME)
+	registerEnumIn("configKeys", ConfigManager::RANDOM_SEED)
 
 	// os
 	registerMethod("os", "mtime", LuaScriptInterface::luaSystemTime);
@@ -1972,6 +2274,16 @@ void LuaScriptInterface::registerFunctions()
 	registerMethod("Game", "getMonsterCount", LuaScriptInterface::luaGameGetMonsterCount);
 	registerMethod("Game", "getPlayerCount", LuaScriptInterface::luaGameGetPlayerCount);
 	registerMethod("Game", "getNpcCount", LuaScriptInterface::luaGameGetNpcCount);
+	registerMethod("Game", "getTileCount", LuaScriptInterface::luaGameGetTileCount);
+	registerMethod("Game", "getSpawnStats", LuaScriptInterface::luaGameGetSpawnStats);
+	registerMethod("Game", "getRandomSeed", LuaScriptInterface::luaGameGetRandomSeed);
+	registerMethod("Game", "getPoolStats", LuaScriptInterface::luaGameGetPoolStats);
+
+	registerMethod("Game", "startLuaProfiler", LuaScriptInterface::luaGameStartLuaProfiler);
+	registerMethod("Game", "stopLuaProfiler", LuaScriptInterface::luaGameStopLuaProfiler);
+	registerMethod("Game", "resetLuaProfiler", LuaScriptInterface::luaGameResetLuaProfiler);
+	registerMethod("Game", "writeLuaProfilerReport", LuaScriptInterface::luaGameWriteLuaProfilerReport);
+	registerMethod("Game", "getLuaGarbageCollectorStats", LuaScriptInterface::luaGameGetLuaGarbageCollectorStats);
 
 	registerMethod("Game", "getTowns", LuaScriptInterface::luaGameGetTowns);
 	registerMethod("Game", "getHouses", LuaScriptInterface::luaGameGetHouses);
@@ -2009,6 +2321,8 @@ void LuaScriptInterface::registerFunctions()
 	registerMetaMethod("Position", "__add", LuaScriptInterface::luaPositionAdd);
 	registerMetaMethod("Position", "__sub", LuaScriptInterface::luaPositionSub);
 	registerMetaMethod("Position", "__eq", LuaScriptInterface::luaPositionCompare);
+	registerMetaMethod("Position", "__index", LuaScriptInterface::luaPositionIndex);
+	registerMetaMethod("Position", "__newindex", LuaScriptInterface::luaPositionNewIndex);
 
 	registerMethod("Position", "getDistance", LuaScriptInterface::luaPositionGetDistance);
 	registerMethod("Position", "isSightClear", LuaScriptInterface::luaPositionIsSightClear);
@@ -2711,6 +3025,7 @@ void LuaScriptInterface::registerFunctions()
 
 	registerMethod("MonsterType", "getLoot", LuaScriptInterface::luaMonsterTypeGetLoot);
 	registerMethod("MonsterType", "addLoot", LuaScriptInterface::luaMonsterTypeAddLoot);
+	registerMethod("MonsterType", "createLoot", LuaScriptInterface::luaMonsterTypeCreateLoot);
 
 	registerMethod("MonsterType", "getCreatureEvents", LuaScriptInterface::luaMonsterTypeGetCreatureEvents);
 	registerMethod("MonsterType", "registerEvent", LuaScriptInterface::luaMonsterTypeRegisterEvent);
@@ -3026,6 +3341,8 @@ void LuaScriptInterface::registerClass(const std::string& className, const std::
 		lua_pushnumber(luaState, LuaData_Npc);
 	} else if (className == "Tile") {
 		lua_pushnumber(luaState, LuaData_Tile);
+	} else if (className == "Position") {
+		lua_pushnumber(luaState, LuaData_Position);
 	} else {
 		lua_pushnumber(luaState, LuaData_Unknown);
 	}
@@ -3976,8 +4293,10 @@ int LuaScriptInterface::luaConfigManagerGetBoolean(lua_State* L)
 const luaL_Reg LuaScriptInterface::luaDatabaseTable[] = {
 	{"query", LuaScriptInterface::luaDatabaseExecute},
 	{"asyncQuery", LuaScriptInterface::luaDatabaseAsyncExecute},
+	{"awaitQuery", LuaScriptInterface::luaDatabaseAwaitQuery},
 	{"storeQuery", LuaScriptInterface::luaDatabaseStoreQuery},
 	{"asyncStoreQuery", LuaScriptInterface::luaDatabaseAsyncStoreQuery},
+	{"awaitStoreQuery", LuaScriptInterface::luaDatabaseAwaitStoreQuery},
 	{"escapeString", LuaScriptInterface::luaDatabaseEscapeString},
 	{"escapeBlob", LuaScriptInterface::luaDatabaseEscapeBlob},
 	{"lastInsertId", LuaScriptInterface::luaDatabaseLastInsertId},
@@ -4065,6 +4384,94 @@ int LuaScriptInterface::luaDatabaseAsyncStoreQuery(lua_State* L)
 	return 0;
 }
 
+namespace {
+
+// the coroutine that suspended itself in the last db.awaitQuery or db.awaitStoreQuery
+const lua_State* awaitingThread = nullptr;
+
+// resumes a coroutine suspended in db.awaitQuery or db.awaitStoreQuery with
+// the outcome of its query, runs on the dispatcher thread
+void resumeDatabaseCoroutine(int32_t threadRef, int32_t scriptId, DBResult_ptr result, bool success, bool store)
+{
+	lua_State* luaState = g_luaEnvironment.getLuaState();
+	if (!luaState) {
+		return;
+	}
+
+	// the registry reference keeps the coroutine alive until it is resumed
+	lua_rawgeti(luaState, LUA_REGISTRYINDEX, threadRef);
+	lua_State* thread = lua_tothread(luaState, -1);
+	lua_pop(luaState, 1);
+
+	if (!thread || lua_status(thread) != LUA_YIELD || !LuaScriptInterface::reserveScriptEnv()) {
+		ScriptEnvironment::releasePinnedResults(thread);
+		luaL_unref(luaState, LUA_REGISTRYINDEX, threadRef);
+		return;
+	}
+
+	ScriptEnvironment* env = LuaScriptInterface::getScriptEnv();
+	env->setScriptId(scriptId, &g_luaEnvironment);
+
+	if (!store) {
+		LuaScriptInterface::pushBoolean(thread, success);
+	} else if (result) {
+		// other scripts reset the environment while the coroutine waits
+		lua_pushnumber(thread, ScriptEnvironment::addPinnedResult(result, thread));
+	} else {
+		LuaScriptInterface::pushBoolean(thread, false);
+	}
+
+	awaitingThread = nullptr;
+	int ret = LuaScriptInterface::instrumentedResume(luaState, thread, 1);
+
+	// unless it waits for the next query, nothing resumes the coroutine again
+	if (ret != LUA_YIELD || awaitingThread != thread) {
+		ScriptEnvironment::releasePinnedResults(thread);
+	}
+
+	if (ret != 0 && ret != LUA_YIELD) {
+		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(thread));
+	} else {
+		// drop whatever the coroutine returned or yielded
+		lua_settop(thread, 0);
+	}
+
+	LuaScriptInterface::resetScriptEnv();
+	luaL_unref(luaState, LUA_REGISTRYINDEX, threadRef);
+}
+
+int awaitDatabaseTask(lua_State* L, bool store)
+{
+	if (lua_pushthread(L) == 1) {
+		lua_pop(L, 1);
+		LuaScriptInterface::reportError(__FUNCTION__, "Can only wait for a query inside a coroutine, see db.async.", true);
+		LuaScriptInterface::pushBoolean(L, false);
+		return 1;
+	}
+
+	int32_t threadRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	int32_t scriptId = LuaScriptInterface::getScriptEnv()->getScriptId();
+	awaitingThread = L;
+	g_databaseTasks.addTask(LuaScriptInterface::getString(L, 1), [threadRef, scriptId, store](DBResult_ptr result, bool success) {
+		resumeDatabaseCoroutine(threadRef, scriptId, std::move(result), success, store);
+	}, store);
+	return lua_yield(L, 0);
+}
+
+}
+
+int LuaScriptInterface::luaDatabaseAwaitQuery(lua_State* L)
+{
+	// db.awaitQuery(query)
+	return awaitDatabaseTask(L, false);
+}
+
+int LuaScriptInterface::luaDatabaseAwaitStoreQuery(lua_State* L)
+{
+	// db.awaitStoreQuery(query)
+	return awaitDatabaseTask(L, true);
+}
+
 int LuaScriptInterface::luaDatabaseEscapeString(lua_State* L)
 {
 	pushString(L, Database::getInstance().escapeString(getString(L, -1)));
@@ -4301,6 +4708,100 @@ int LuaScriptInterface::luaGameGetNpcCount(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaGameGetTileCount(lua_State* L)
+{
+	// Game.getTileCount()
+	lua_pushnumber(L, g_game.map.getTileCount());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetRandomSeed(lua_State* L)
+{
+	// Game.getRandomSeed()
+	lua_pushnumber(L, getRandomSeed());
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetSpawnStats(lua_State* L)
+{
+	// Game.getSpawnStats()
+	const SpawnStats stats = g_game.map.spawns.getStats();
+	lua_createtable(L, 0, 5);
+	setField(L, "queries", stats.queries);
+	setField(L, "spawns", stats.spawns);
+	setField(L, "queriesPerSecond", stats.queriesPerSecond);
+	setField(L, "pending", stats.pending);
+	setField(L, "blocked", stats.blocked);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetPoolStats(lua_State* L)
+{
+	// Game.getPoolStats()
+	const std::vector<SlabPoolStats> stats = SlabPoolBase::getAllStats();
+	lua_createtable(L, 0, stats.size());
+	for (const SlabPoolStats& poolStats : stats) {
+		lua_createtable(L, 0, 4);
+		setField(L, "objectSize", poolStats.objectSize);
+		setField(L, "live", poolStats.live);
+		setField(L, "free", poolStats.free);
+		setField(L, "slabs", poolStats.slabs);
+		lua_setfield(L, -2, poolStats.name);
+	}
+	return 1;
+}
+
+int LuaScriptInterface::luaGameStartLuaProfiler(lua_State* L)
+{
+	// Game.startLuaProfiler([sampleInterval = 0])
+	g_luaProfiler.start(getNumber<uint32_t>(L, 1, 0));
+	pushBoolean(L, true);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameStopLuaProfiler(lua_State* L)
+{
+	// Game.stopLuaProfiler()
+	g_luaProfiler.stop();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameResetLuaProfiler(lua_State* L)
+{
+	// Game.resetLuaProfiler()
+	g_luaProfiler.reset();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameWriteLuaProfilerReport(lua_State* L)
+{
+	// Game.writeLuaProfilerReport([reportFile = "data/logs/lua_profiler.log"[, foldedFile = "data/logs/lua_profiler.folded"]])
+	const std::string reportFile = getString(L, 1);
+	const std::string foldedFile = getString(L, 2);
+	bool written = g_luaProfiler.writeReport(reportFile.empty() ? "data/logs/lua_profiler.log" : reportFile);
+	written = g_luaProfiler.writeFoldedStacks(foldedFile.empty() ? "data/logs/lua_profiler.folded" : foldedFile) && written;
+	pushBoolean(L, written);
+	return 1;
+}
+
+int LuaScriptInterface::luaGameGetLuaGarbageCollectorStats(lua_State* L)
+{
+	// Game.getLuaGarbageCollectorStats()
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	const LuaGarbageCollectorStats& stats = g_luaEnvironment.getGarbageCollectorStats();
+	lua_createtable(L, 0, 5);
+	setField(L, "memory", lua_gc(L, LUA_GCCOUNT, 0));
+	setField(L, "steps", stats.steps);
+	setField(L, "cycles", stats.cycles);
+	setField(L, "totalPause", duration_cast<microseconds>(stats.totalPause).count());
+	setField(L, "maxPause", duration_cast<microseconds>(stats.maxPause).count());
+	return 1;
+}
+
 int LuaScriptInterface::luaGameGetTowns(lua_State* L)
 {
 	// Game.getTowns()
@@ -4508,7 +5009,7 @@ int LuaScriptInterface::luaGameCreateTile(lua_State* L)
 	// Game.createTile(position[, isDynamic = false])
 	Position position;
 	bool isDynamic;
-	if (isTable(L, 1)) {
+	if (isPosition(L, 1)) {
 		position = getPosition(L, 1);
 		isDynamic = getBoolean(L, 2, false);
 	} else {
@@ -4601,6 +5102,11 @@ int LuaScriptInterface::luaGameReload(lua_State* L)
 {
 	// Game.reload(reloadType)
 	ReloadTypes_t reloadType = getNumber<ReloadTypes_t>(L, 1);
+
+	const auto startTime = std::chrono::steady_clock::now();
+	const uint64_t compiledCount = g_luaChunkCache.getCompiledCount();
+	const uint64_t cachedCount = g_luaChunkCache.getCachedCount();
+
 	if (reloadType == RELOAD_TYPE_GLOBAL) {
 		pushBoolean(L, g_luaEnvironment.loadFile("data/global.lua") == 0);
 		pushBoolean(L, g_scripts->loadScripts("scripts/lib", true, true));
@@ -4608,6 +5114,11 @@ int LuaScriptInterface::luaGameReload(lua_State* L)
 		pushBoolean(L, g_game.reload(reloadType));
 	}
 	lua_gc(g_luaEnvironment.getLuaState(), LUA_GCCOLLECT, 0);
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+	std::cout << "> Reload type " << reloadType << " took " << elapsed.count() << " ms, "
+		<< (g_luaChunkCache.getCompiledCount() - compiledCount) << " scripts compiled, "
+		<< (g_luaChunkCache.getCachedCount() - cachedCount) << " loaded from cache." << std::endl;
 	return 1;
 }
 
@@ -4616,14 +5127,14 @@ int LuaScriptInterface::luaVariantCreate(lua_State* L)
 {
 	// Variant(number or string or position or thing)
 	LuaVariant variant;
-	if (isUserdata(L, 2)) {
+	if (isPosition(L, 2)) {
+		variant.type = VARIANT_POSITION;
+		variant.pos = getPosition(L, 2);
+	} else if (isUserdata(L, 2)) {
 		if (Thing* thing = getThing(L, 2)) {
 			variant.type = VARIANT_TARGETPOSITION;
 			variant.pos = thing->getPosition();
 		}
-	} else if (isTable(L, 2)) {
-		variant.type = VARIANT_POSITION;
-		variant.pos = getPosition(L, 2);
 	} else if (isNumber(L, 2)) {
 		variant.type = VARIANT_NUMBER;
 		variant.number = getNumber<uint32_t>(L, 2);
@@ -4682,7 +5193,7 @@ int LuaScriptInterface::luaPositionCreate(lua_State* L)
 	}
 
 	int32_t stackpos;
-	if (isTable(L, 2)) {
+	if (isPosition(L, 2)) {
 		const Position& position = getPosition(L, 2, stackpos);
 		pushPosition(L, position, stackpos);
 	} else {
@@ -4739,6 +5250,122 @@ int LuaScriptInterface::luaPositionCompare(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaPositionIndex(lua_State* L)
+{
+	// position.x, position.y, position.z, position.stackpos
+	// position:method()
+	// only reached through the Position metatable, so a userdata is always one of ours
+	LuaPosition* userdata = nullptr;
+	if (lua_type(L, 1) == LUA_TUSERDATA) {
+		userdata = static_cast<LuaPosition*>(lua_touserdata(L, 1));
+	}
+
+	size_t length = 0;
+	const char* key = isString(L, 2) && !isNumber(L, 2) ? lua_tolstring(L, 2, &length) : nullptr;
+	if (userdata && key) {
+		if (length == 1) {
+			if (key[0] == 'x') {
+				lua_pushnumber(L, userdata->position.x);
+				return 1;
+			} else if (key[0] == 'y') {
+				lua_pushnumber(L, userdata->position.y);
+				return 1;
+			} else if (key[0] == 'z') {
+				lua_pushnumber(L, userdata->position.z);
+				return 1;
+			}
+		} else if (strcmp(key, "stackpos") == 0) {
+			lua_pushnumber(L, userdata->stackpos);
+			return 1;
+		}
+	}
+
+	// Position methods, the class table is the protected __metatable value
+	lua_getmetatable(L, 1);
+	lua_getfield(L, -1, "__metatable");
+	lua_pushvalue(L, 2);
+	lua_gettable(L, -2);
+	if (!lua_isnil(L, -1) || !userdata) {
+		return 1;
+	}
+
+	// fields scripts stored on the position themselves
+	lua_getfield(L, LUA_REGISTRYINDEX, "PositionFields");
+	if (!isTable(L, -1)) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_pushvalue(L, 1);
+	lua_rawget(L, -2);
+	if (!isTable(L, -1)) {
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_pushvalue(L, 2);
+	lua_rawget(L, -2);
+	return 1;
+}
+
+int LuaScriptInterface::luaPositionNewIndex(lua_State* L)
+{
+	// position.x = value
+	if (lua_type(L, 1) != LUA_TUSERDATA) {
+		lua_rawset(L, 1);
+		return 0;
+	}
+
+	LuaPosition* userdata = static_cast<LuaPosition*>(lua_touserdata(L, 1));
+	size_t length = 0;
+	const char* key = isString(L, 2) && !isNumber(L, 2) ? lua_tolstring(L, 2, &length) : nullptr;
+	if (key) {
+		if (length == 1) {
+			if (key[0] == 'x') {
+				userdata->position.x = getNumber<uint16_t>(L, 3);
+				return 0;
+			} else if (key[0] == 'y') {
+				userdata->position.y = getNumber<uint16_t>(L, 3);
+				return 0;
+			} else if (key[0] == 'z') {
+				userdata->position.z = getNumber<uint8_t>(L, 3);
+				return 0;
+			}
+		} else if (strcmp(key, "stackpos") == 0) {
+			userdata->stackpos = getNumber<int32_t>(L, 3);
+			return 0;
+		}
+	}
+
+	// any other key goes to a side table keyed weakly by the position
+	lua_getfield(L, LUA_REGISTRYINDEX, "PositionFields");
+	if (!isTable(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_createtable(L, 0, 1);
+		lua_pushstring(L, "k");
+		lua_setfield(L, -2, "__mode");
+		lua_setmetatable(L, -2);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, LUA_REGISTRYINDEX, "PositionFields");
+	}
+
+	lua_pushvalue(L, 1);
+	lua_rawget(L, -2);
+	if (!isTable(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
+		lua_pushvalue(L, 1);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, -4);
+	}
+
+	lua_pushvalue(L, 2);
+	lua_pushvalue(L, 3);
+	lua_rawset(L, -3);
+	return 0;
+}
+
 int LuaScriptInterface::luaPositionGetDistance(lua_State* L)
 {
 	// position:getDistance(positionEx)
@@ -4817,7 +5444,7 @@ int LuaScriptInterface::luaTileCreate(lua_State* L)
 	// Tile(x, y, z)
 	// Tile(position)
 	Tile* tile;
-	if (isTable(L, 2)) {
+	if (isPosition(L, 2)) {
 		tile = g_game.map.getTile(getPosition(L, 2));
 	} else {
 		uint8_t z = getNumber<uint8_t>(L, 4);
@@ -6556,6 +7183,9 @@ int LuaScriptInterface::luaItemMoveTo(lua_State* L)
 			case LuaData_Tile:
 				toCylinder = getUserdata<Tile>(L, 2);
 				break;
+			case LuaData_Position:
+				toCylinder = g_game.map.getTile(getPosition(L, 2));
+				break;
 			default:
 				toCylinder = nullptr;
 				break;
@@ -7565,6 +8195,7 @@ int LuaScriptInterface::luaCreatureSetOutfit(lua_State* L)
 int LuaScriptInterface::luaCreatureGetCondition(lua_State* L)
 {
 	// creature:getCondition(conditionType[, conditionId = CONDITIONID_COMBAT[, subId = 0]])
+	// running default id spell and group cooldowns are no conditions, use hasCondition
 	Creature* creature = getUserdata<Creature>(L, 1);
 	if (!creature) {
 		lua_pushnil(L);
@@ -7611,6 +8242,15 @@ int LuaScriptInterface::luaCreatureRemoveCondition(lua_State* L)
 	ConditionType_t conditionType = getNumber<ConditionType_t>(L, 2);
 	ConditionId_t conditionId = getNumber<ConditionId_t>(L, 3, CONDITIONID_COMBAT);
 	uint32_t subId = getNumber<uint32_t>(L, 4, 0);
+
+	// default id cooldowns live in the cooldown table, not as conditions
+	if (conditionId == CONDITIONID_DEFAULT && (conditionType == CONDITION_SPELLCOOLDOWN || conditionType == CONDITION_SPELLGROUPCOOLDOWN)) {
+		if (creature->removeCooldown(conditionType, subId)) {
+			pushBoolean(L, true);
+			return 1;
+		}
+	}
+
 	Condition* condition = creature->getCondition(conditionType, conditionId, subId);
 	if (condition) {
 		bool force = getBoolean(L, 5, false);
@@ -12855,6 +13495,19 @@ int LuaScriptInterface::luaMonsterTypeAddLoot(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaMonsterTypeCreateLoot(lua_State* L)
+{
+	// monsterType:createLoot(corpse)
+	MonsterType* monsterType = getUserdata<MonsterType>(L, 1);
+	Container* corpse = getUserdata<Container>(L, 2);
+	if (monsterType && corpse) {
+		pushBoolean(L, monsterType->createLoot(corpse));
+	} else {
+		lua_pushnil(L);
+	}
+	return 1;
+}
+
 int LuaScriptInterface::luaMonsterTypeGetCreatureEvents(lua_State* L)
 {
 	// monsterType:getCreatureEvents()
@@ -16134,6 +16787,10 @@ bool LuaEnvironment::initState()
 
 	luaL_openlibs(luaState);
 	registerFunctions();
+	g_luaProfiler.attach(luaState);
+
+	gcCycleRunning = false;
+	gcIdleThreshold = 0;
 
 	runningEventId = EVENT_ID_USER;
 	return true;
@@ -16178,6 +16835,53 @@ bool LuaEnvironment::closeState()
 	return true;
 }
 
+bool LuaEnvironment::collectGarbageStep()
+{
+	// a step should never hold back a task that arrives meanwhile for long,
+	// the step size follows the measured pause towards this budget
+	static constexpr auto stepBudget = std::chrono::microseconds(500);
+	static constexpr int minStepSize = 16, maxStepSize = 4096;
+
+	if (!luaState) {
+		return false;
+	}
+
+	if (!gcCycleRunning) {
+		// only start a cycle once the heap grew by a quarter since the last
+		// one, the regular collector may have run in between as well
+		const int memory = lua_gc(luaState, LUA_GCCOUNT, 0);
+		if (memory < gcIdleThreshold) {
+			return false;
+		}
+		gcCycleRunning = true;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const bool finished = lua_gc(luaState, LUA_GCSTEP, gcStepSize) != 0;
+	const auto pause = std::chrono::steady_clock::now() - start;
+
+	++gcStats.steps;
+	gcStats.totalPause += pause;
+	if (pause > gcStats.maxPause) {
+		gcStats.maxPause = pause;
+	}
+
+	if (pause < stepBudget / 2) {
+		gcStepSize = std::min<int>(gcStepSize * 2, maxStepSize);
+	} else if (pause > stepBudget) {
+		gcStepSize = std::max<int>(gcStepSize / 2, minStepSize);
+	}
+
+	if (finished) {
+		++gcStats.cycles;
+		gcCycleRunning = false;
+
+		const int memory = lua_gc(luaState, LUA_GCCOUNT, 0);
+		gcIdleThreshold = memory + memory / 4;
+	}
+	return gcCycleRunning;
+}
+
 LuaScriptInterface* LuaEnvironment::getTestInterface()
 {
 	if (!testInterface) {
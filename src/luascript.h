@@ -34,8 +34,12 @@
 #undef lua_equal
 #define lua_equal(L, i1, i2) lua_compare(L, (i1), (i2), LUA_OPEQ)
 #endif
+#ifndef lua_objlen
+#define lua_objlen lua_rawlen
+#endif
 #endif
 
+#include "configmanager.h"
 #include "database.h"
 #include "enums.h"
 #include "position.h"
@@ -77,6 +81,7 @@ enum LuaDataType {
 	LuaData_Monster,
 	LuaData_Npc,
 	LuaData_Tile,
+	LuaData_Position,
 };
 
 struct LuaVariant {
@@ -86,6 +91,15 @@ struct LuaVariant {
 	uint32_t number = 0;
 };
 
+// payload of the Position userdata, see LuaScriptInterface::pushPosition
+struct LuaPosition {
+	Position position;
+	int32_t stackpos;
+};
+
+// the userdata getters tell positions and object pointers apart by size
+static_assert(sizeof(LuaPosition) != sizeof(void*), "LuaPosition must not be pointer sized");
+
 struct LuaTimerEventDesc {
 	int32_t scriptId = -1;
 	int32_t function = -1;
@@ -141,6 +155,10 @@ class ScriptEnvironment
 		static DBResult_ptr getResultByID(uint32_t id);
 		static uint32_t addResult(DBResult_ptr res);
 		static bool removeResult(uint32_t id);
+		// results of db.awaitStoreQuery, they survive environment resets
+		// until freed or until their coroutine is done
+		static uint32_t addPinnedResult(DBResult_ptr res, const lua_State* owner);
+		static void releasePinnedResults(const lua_State* owner);
 
 		void setNpc(Npc* npc) {
 			curNpc = npc;
@@ -159,6 +177,11 @@ class ScriptEnvironment
 		using StorageMap = std::map<uint32_t, int32_t>;
 		using DBResultMap = std::map<uint32_t, DBResult_ptr>;
 
+		struct PinnedResult {
+			const lua_State* owner;
+			DBResult_ptr result;
+		};
+
 		LuaScriptInterface* interface;
 
 		//for npc scripts
@@ -179,6 +202,7 @@ class ScriptEnvironment
 		//result map
 		static uint32_t lastResultId;
 		static DBResultMap tempResults;
+		static std::map<uint32_t, PinnedResult> pinnedResults;
 };
 
 #define reportErrorFunc(a)  reportError(__FUNCTION__, a, true)
@@ -224,6 +248,10 @@ class LuaScriptInterface
 			return scriptEnv + scriptEnvIndex;
 		}
 
+		static bool hasScriptEnv() {
+			return scriptEnvIndex >= 0;
+		}
+
 		static bool reserveScriptEnv() {
 			return ++scriptEnvIndex < 16;
 		}
@@ -242,6 +270,31 @@ class LuaScriptInterface
 			return lastLuaError;
 		}
 
+		// the config key holding this interface's script budget, a value
+		// of 0 there falls back to the global scriptBudget
+		void setBudgetConfig(ConfigManager::integer_config_t budgetConfig) {
+			this->budgetConfig = budgetConfig;
+		}
+		int64_t getBudget() const;
+
+		// the interface name and script of the running call, read by the
+		// dispatcher watchdog from its own thread; the name is empty when
+		// no script is running
+		static std::string getRunningInterfaceName();
+		static int32_t getRunningScriptId() {
+			return runningScriptId.load(std::memory_order_relaxed);
+		}
+
+		// (re)installs the count hook shared by the script budget, the
+		// profiler and the watchdog stack dump
+		static void updateHook(lua_State* L);
+
+		// asks the running call to log its Lua stack, safe from any thread;
+		// the call's count hook prints it on the dispatcher thread
+		static void requestStackDump() {
+			stackDumpRequested.store(true);
+		}
+
 		lua_State* getLuaState() const {
 			return luaState;
 		}
@@ -311,6 +364,10 @@ class LuaScriptInterface
 		template<class T>
 		static T** getRawUserdata(lua_State* L, int32_t arg)
 		{
+			// positions are userdata too, but they hold the position itself
+			if (lua_type(L, arg) != LUA_TUSERDATA || lua_objlen(L, arg) != sizeof(T*)) {
+				return nullptr;
+			}
 			return static_cast<T**>(lua_touserdata(L, arg));
 		}
 
@@ -348,6 +405,7 @@ class LuaScriptInterface
 		static std::string getFieldString(lua_State* L, int32_t arg, const std::string& key);
 
 		static LuaDataType getUserdataType(lua_State* L, int32_t arg);
+		static LuaPosition* getPositionUserdata(lua_State* L, int32_t arg);
 
 		// Is
 		static bool isNumber(lua_State* L, int32_t arg)
@@ -372,7 +430,18 @@ class LuaScriptInterface
 		}
 		static bool isUserdata(lua_State* L, int32_t arg)
 		{
-			return lua_isuserdata(L, arg) != 0;
+			return lua_isuserdata(L, arg) != 0 && lua_objlen(L, arg) != sizeof(LuaPosition);
+		}
+		static bool isPosition(lua_State* L, int32_t arg)
+		{
+#ifdef LUAJIT_VERSION
+			// positions from the FFI getters (data/lib/core/luajit.lua) are
+			// cdata, lua.h doesn't name LUA_TCDATA
+			if (lua_type(L, arg) == 10) {
+				return true;
+			}
+#endif
+			return isTable(L, arg) || getPositionUserdata(L, arg);
 		}
 
 		// Push
@@ -402,10 +471,13 @@ class LuaScriptInterface
 		static const luaL_Reg luaBitReg[7];
 #endif
 		static const luaL_Reg luaConfigManagerTable[4];
-		static const luaL_Reg luaDatabaseTable[9];
+		static const luaL_Reg luaDatabaseTable[11];
 		static const luaL_Reg luaResultTable[6];
 
 		static int protectedCall(lua_State* L, int nargs, int nresults);
+		static int instrumentedCall(lua_State* L, int nargs, int nresults);
+		// lua_resume under the same budget, profiler and watchdog coverage
+		static int instrumentedResume(lua_State* L, lua_State* thread, int nargs);
 
 	protected:
 		virtual bool closeState();
@@ -506,6 +578,8 @@ class LuaScriptInterface
 		static int luaDatabaseAsyncExecute(lua_State* L);
 		static int luaDatabaseStoreQuery(lua_State* L);
 		static int luaDatabaseAsyncStoreQuery(lua_State* L);
+		static int luaDatabaseAwaitQuery(lua_State* L);
+		static int luaDatabaseAwaitStoreQuery(lua_State* L);
 		static int luaDatabaseEscapeString(lua_State* L);
 		static int luaDatabaseEscapeBlob(lua_State* L);
 		static int luaDatabaseLastInsertId(lua_State* L);
@@ -539,6 +613,16 @@ class LuaScriptInterface
 		static int luaGameGetMonsterCount(lua_State* L);
 		static int luaGameGetPlayerCount(lua_State* L);
 		static int luaGameGetNpcCount(lua_State* L);
+		static int luaGameGetTileCount(lua_State* L);
+		static int luaGameGetSpawnStats(lua_State* L);
+		static int luaGameGetRandomSeed(lua_State* L);
+		static int luaGameGetPoolStats(lua_State* L);
+
+		static int luaGameStartLuaProfiler(lua_State* L);
+		static int luaGameStopLuaProfiler(lua_State* L);
+		static int luaGameResetLuaProfiler(lua_State* L);
+		static int luaGameWriteLuaProfilerReport(lua_State* L);
+		static int luaGameGetLuaGarbageCollectorStats(lua_State* L);
 
 		static int luaGameGetTowns(lua_State* L);
 		static int luaGameGetHouses(lua_State* L);
@@ -576,6 +660,8 @@ class LuaScriptInterface
 		static int luaPositionAdd(lua_State* L);
 		static int luaPositionSub(lua_State* L);
 		static int luaPositionCompare(lua_State* L);
+		static int luaPositionIndex(lua_State* L);
+		static int luaPositionNewIndex(lua_State* L);
 
 		static int luaPositionGetDistance(lua_State* L);
 		static int luaPositionIsSightClear(lua_State* L);
@@ -1255,6 +1341,7 @@ class LuaScriptInterface
 
 		static int luaMonsterTypeGetLoot(lua_State* L);
 		static int luaMonsterTypeAddLoot(lua_State* L);
+		static int luaMonsterTypeCreateLoot(lua_State* L);
 
 		static int luaMonsterTypeGetCreatureEvents(lua_State* L);
 		static int luaMonsterTypeRegisterEvent(lua_State* L);
@@ -1474,11 +1561,32 @@ class LuaScriptInterface
 		std::string lastLuaError;
 
 		std::string interfaceName;
+		// stable id of interfaceName, the watchdog looks the name up by it
+		int32_t interfaceId;
 
 		static ScriptEnvironment scriptEnv[16];
 		static int32_t scriptEnvIndex;
 
+		static void executionHook(lua_State* L, lua_Debug* ar);
+
+		template <typename Call>
+		static int instrumented(lua_State* L, Call call);
+
+		static const LuaScriptInterface* runningInterface;
+		static std::atomic<int32_t> runningInterfaceId;
+		static std::atomic<int32_t> runningScriptId;
+		static std::atomic<bool> stackDumpRequested;
+
 		std::string loadingFile;
+
+		ConfigManager::integer_config_t budgetConfig = ConfigManager::SCRIPT_BUDGET;
+};
+
+struct LuaGarbageCollectorStats {
+	uint64_t steps = 0;
+	uint64_t cycles = 0;
+	std::chrono::nanoseconds totalPause{0};
+	std::chrono::nanoseconds maxPause{0};
 };
 
 class LuaEnvironment : public LuaScriptInterface
@@ -1505,9 +1613,21 @@ class LuaEnvironment : public LuaScriptInterface
 		uint32_t createAreaObject(LuaScriptInterface* interface);
 		void clearAreaObjects(LuaScriptInterface* interface);
 
+		// runs one incremental garbage collector step, called by the dispatcher
+		// when its task queue is empty, returns true while a cycle is unfinished
+		bool collectGarbageStep();
+		const LuaGarbageCollectorStats& getGarbageCollectorStats() const {
+			return gcStats;
+		}
+
 	private:
 		void executeTimerEvent(uint32_t eventIndex);
 
+		LuaGarbageCollectorStats gcStats;
+		int gcStepSize = 64;
+		int gcIdleThreshold = 0;
+		bool gcCycleRunning = false;
+
 		std::unordered_map<uint32_t, LuaTimerEventDesc> timerEvents;
 		std::unordered_map<uint32_t, Combat*> combatMap;
 		std::unordered_map<uint32_t, AreaCombat*> areaMap;
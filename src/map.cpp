@@ -24,13 +24,20 @@
 #include "combat.h"
 #include "creature.h"
 #include "game.h"
+#include "pool.h"
 
 extern Game g_game;
 
 bool Map::loadMap(const std::string& identifier, bool loadHouses)
 {
 	IOMap loader;
-	if (!loader.loadMap(this, identifier)) {
+
+	// the map items and tiles live for the whole uptime, pack them into large slabs
+	SlabPoolBase::setBulkLoad(true);
+	bool loaded = loader.loadMap(this, identifier);
+	SlabPoolBase::setBulkLoad(false);
+
+	if (!loaded) {
 		std::cout << "[Fatal - Map::loadMap] " << loader.getLastErrorString() << std::endl;
 		return false;
 	}
@@ -150,7 +157,68 @@ void Map::setTile(uint16_t x, uint16_t y, uint8_t z, Tile* newTile)
 		delete newTile;
 	} else {
 		tile = newTile;
+		++tileCount;
+	}
+
+	floor->updateMasks(x, y, tile);
+}
+
+uint32_t Map::compactEmptyTiles(uint32_t blocks, bool& passCompleted)
+{
+	passCompleted = false;
+
+	const uint32_t blocksX = (width + FLOOR_MASK) / FLOOR_SIZE;
+	const uint32_t blocksY = (height + FLOOR_MASK) / FLOOR_SIZE;
+	if (blocksX == 0 || blocksY == 0) {
+		return 0;
+	}
+
+	uint32_t removed = 0;
+	for (; blocks != 0; --blocks) {
+		if (compactionCursor >= blocksX * blocksY) {
+			compactionCursor = 0;
+			passCompleted = true;
+			break;
+		}
+
+		const uint32_t blockX = (compactionCursor % blocksX) * FLOOR_SIZE;
+		const uint32_t blockY = (compactionCursor / blocksX) * FLOOR_SIZE;
+		++compactionCursor;
+
+		QTreeLeafNode* leaf = getQTNode(blockX, blockY);
+		if (!leaf) {
+			continue;
+		}
+
+		for (uint8_t z = 0; z < MAP_MAX_LAYERS; ++z) {
+			Floor* floor = leaf->getFloor(z);
+			if (!floor) {
+				continue;
+			}
+
+			for (uint32_t offsetX = 0; offsetX < FLOOR_SIZE; ++offsetX) {
+				for (uint32_t offsetY = 0; offsetY < FLOOR_SIZE; ++offsetY) {
+					// only tiles an area effect created, map and script tiles may be
+					// referenced by houses, Lua userdata or an open browse field
+					Tile*& tile = floor->tiles[offsetX][offsetY];
+					if (!tile || tile->getThingCount() != 0 || !tile->hasFlag(TILESTATE_EPHEMERAL) || tile->hasFlag(~TILESTATE_EPHEMERAL)) {
+						continue;
+					}
+
+					if (g_game.browseFields.find(tile) != g_game.browseFields.end()) {
+						continue;
+					}
+
+					delete tile;
+					tile = nullptr;
+					floor->updateMasks(offsetX, offsetY, nullptr);
+					--tileCount;
+					++removed;
+				}
+			}
+		}
 	}
+	return removed;
 }
 
 bool Map::placeCreature(const Position& centerPos, Creature* creature, bool extendedPos/* = false*/, bool forceLogin/* = false*/)
@@ -222,11 +290,19 @@ bool Map::placeCreature(const Position& centerPos, Creature* creature, bool exte
 
 	const Position& dest = toCylinder->getPosition();
 	getQTNode(dest.x, dest.y)->addCreature(creature);
+	if (creature->getPlayer()) {
+		addRegionPlayer(dest);
+	}
 	return true;
 }
 
 void Map::moveCreature(Creature& creature, Tile& newTile, bool forceTeleport/* = false*/)
 {
+	if (creature.sleeping) {
+		// it may be moved next to a player, let it look around
+		g_game.addCreatureCheck(&creature);
+	}
+
 	Tile& oldTile = *creature.getTile();
 
 	Position oldPos = oldTile.getPosition();
@@ -262,6 +338,16 @@ void Map::moveCreature(Creature& creature, Tile& newTile, bool forceTeleport/* =
 		new_leaf->addCreature(&creature);
 	}
 
+	if (creature.getPlayer()) {
+		if ((oldPos.x >> regionSizeBits) != (newPos.x >> regionSizeBits) || (oldPos.y >> regionSizeBits) != (newPos.y >> regionSizeBits)) {
+			removeRegionPlayer(oldPos);
+			addRegionPlayer(newPos);
+		}
+
+		// respawns this player was blocking may be out of sight now
+		spawns.retryBlockedRespawns(oldPos, &newPos);
+	}
+
 	//add the creature
 	newTile.addThing(&creature);
 
@@ -414,28 +500,7 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 	if (!foundCache) {
 		int32_t minRangeZ;
 		int32_t maxRangeZ;
-
-		if (multifloor) {
-			if (centerPos.z > 7) {
-				//underground
-
-				//8->15
-				minRangeZ = std::max<int32_t>(centerPos.getZ() - 2, 0);
-				maxRangeZ = std::min<int32_t>(centerPos.getZ() + 2, MAP_MAX_LAYERS - 1);
-			} else if (centerPos.z == 6) {
-				minRangeZ = 0;
-				maxRangeZ = 8;
-			} else if (centerPos.z == 7) {
-				minRangeZ = 0;
-				maxRangeZ = 9;
-			} else {
-				minRangeZ = 0;
-				maxRangeZ = 7;
-			}
-		} else {
-			minRangeZ = centerPos.z;
-			maxRangeZ = centerPos.z;
-		}
+		getSpectatorFloors(centerPos, multifloor, minRangeZ, maxRangeZ);
 
 		getSpectatorsInternal(spectators, centerPos, minRangeX, maxRangeX, minRangeY, maxRangeY, minRangeZ, maxRangeZ, onlyPlayers);
 
@@ -449,6 +514,47 @@ void Map::getSpectators(SpectatorVec& spectators, const Position& centerPos, boo
 	}
 }
 
+void Map::getSpectatorFloors(const Position& centerPos, bool multifloor, int32_t& minRangeZ, int32_t& maxRangeZ)
+{
+	if (multifloor) {
+		if (centerPos.z > 7) {
+			//underground
+
+			//8->15
+			minRangeZ = std::max<int32_t>(centerPos.getZ() - 2, 0);
+			maxRangeZ = std::min<int32_t>(centerPos.getZ() + 2, MAP_MAX_LAYERS - 1);
+		} else if (centerPos.z == 6) {
+			minRangeZ = 0;
+			maxRangeZ = 8;
+		} else if (centerPos.z == 7) {
+			minRangeZ = 0;
+			maxRangeZ = 9;
+		} else {
+			minRangeZ = 0;
+			maxRangeZ = 7;
+		}
+	} else {
+		minRangeZ = centerPos.z;
+		maxRangeZ = centerPos.z;
+	}
+}
+
+bool Map::isSpectatorOf(const Position& centerPos, const Position& spectatorPos, bool multifloor)
+{
+	int32_t minRangeZ;
+	int32_t maxRangeZ;
+	getSpectatorFloors(centerPos, multifloor, minRangeZ, maxRangeZ);
+	if (minRangeZ > spectatorPos.z || maxRangeZ < spectatorPos.z) {
+		return false;
+	}
+
+	// same bounds as getSpectatorsInternal
+	const int32_t offsetZ = Position::getOffsetZ(centerPos, spectatorPos);
+	const int32_t offsetX = spectatorPos.x - centerPos.x - offsetZ;
+	const int32_t offsetY = spectatorPos.y - centerPos.y - offsetZ;
+	return offsetX >= -maxViewportX && offsetX <= maxViewportX && offsetY >= -maxViewportY && offsetY <= maxViewportY;
+}
+
 void Map::clearSpectatorCache()
 {
 	spectatorCache.clear();
@@ -457,6 +563,89 @@ void Map::clearSpectatorCache()
 void Map::clearPlayersSpectatorCache()
 {
 	playersSpectatorCache.clear();
+	++playersSpectatorEpoch;
+}
+
+bool Map::isRegionActive(const Position& pos) const
+{
+	if (regionPlayers.empty()) {
+		return false;
+	}
+
+	const uint32_t regionX = pos.x >> regionSizeBits;
+	const uint32_t regionY = pos.y >> regionSizeBits;
+	for (uint32_t x = std::max<uint32_t>(regionX, 1) - 1; x <= regionX + 1; ++x) {
+		for (uint32_t y = std::max<uint32_t>(regionY, 1) - 1; y <= regionY + 1; ++y) {
+			if (regionPlayers.find(getRegionKey(x, y)) != regionPlayers.end()) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void Map::addRegionPlayer(const Position& pos)
+{
+	const uint32_t regionX = pos.x >> regionSizeBits;
+	const uint32_t regionY = pos.y >> regionSizeBits;
+	if (regionPlayers[getRegionKey(regionX, regionY)]++ != 0) {
+		return;
+	}
+
+	// the regions around just became active, wake everyone sleeping there
+	for (uint32_t x = std::max<uint32_t>(regionX, 1) - 1; x <= regionX + 1; ++x) {
+		for (uint32_t y = std::max<uint32_t>(regionY, 1) - 1; y <= regionY + 1; ++y) {
+			auto it = regionSleepers.find(getRegionKey(x, y));
+			if (it == regionSleepers.end()) {
+				continue;
+			}
+
+			std::vector<Creature*> sleepers = std::move(it->second);
+			regionSleepers.erase(it);
+
+			for (Creature* creature : sleepers) {
+				creature->sleeping = false;
+				g_game.addCreatureCheck(creature);
+				g_game.ReleaseCreature(creature);
+			}
+		}
+	}
+}
+
+void Map::removeRegionPlayer(const Position& pos)
+{
+	auto it = regionPlayers.find(getRegionKey(pos.x >> regionSizeBits, pos.y >> regionSizeBits));
+	if (it != regionPlayers.end() && --it->second == 0) {
+		regionPlayers.erase(it);
+	}
+}
+
+void Map::addSleeper(Creature* creature)
+{
+	const Position& pos = creature->getPosition();
+	regionSleepers[getRegionKey(pos.x >> regionSizeBits, pos.y >> regionSizeBits)].push_back(creature);
+	creature->sleeping = true;
+	creature->incrementReferenceCounter();
+}
+
+void Map::removeSleeper(Creature* creature)
+{
+	const Position& pos = creature->getPosition();
+	auto it = regionSleepers.find(getRegionKey(pos.x >> regionSizeBits, pos.y >> regionSizeBits));
+	if (it != regionSleepers.end()) {
+		std::vector<Creature*>& sleepers = it->second;
+		auto sleeper = std::find(sleepers.begin(), sleepers.end(), creature);
+		if (sleeper != sleepers.end()) {
+			*sleeper = sleepers.back();
+			sleepers.pop_back();
+			if (sleepers.empty()) {
+				regionSleepers.erase(it);
+			}
+		}
+	}
+
+	creature->sleeping = false;
+	g_game.ReleaseCreature(creature);
 }
 
 bool Map::canThrowObjectTo(const Position& fromPos, const Position& toPos, bool checkLineOfSight /*= true*/,
@@ -490,6 +679,12 @@ bool Map::canThrowObjectTo(const Position& fromPos, const Position& toPos, bool
 }
 
 bool Map::checkSightLine(const Position& fromPos, const Position& toPos) const
+{
+	FloorMaskCache cache(FLOORMASK_BLOCKPROJECTILE);
+	return checkSightLine(fromPos, toPos, cache);
+}
+
+bool Map::checkSightLine(const Position& fromPos, const Position& toPos, FloorMaskCache& cache) const
 {
 	if (fromPos == toPos) {
 		return true;
@@ -518,8 +713,7 @@ bool Map::checkSightLine(const Position& fromPos, const Position& toPos) const
 			start.x += mx;
 		}
 
-		const Tile* tile = getTile(start.x, start.y, start.z);
-		if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+		if (cache.isSet(*this, start.x, start.y, start.z)) {
 			return false;
 		}
 	}
@@ -537,14 +731,100 @@ bool Map::checkSightLine(const Position& fromPos, const Position& toPos) const
 	return true;
 }
 
+uint64_t Map::getFloorMask(uint16_t x, uint16_t y, uint8_t z, FloorMask_t mask) const
+{
+	if (z >= MAP_MAX_LAYERS) {
+		return 0;
+	}
+
+	const QTreeLeafNode* leaf = QTreeNode::getLeafStatic<const QTreeLeafNode*, const QTreeNode*>(&root, x, y);
+	if (!leaf) {
+		return 0;
+	}
+
+	const Floor* floor = leaf->getFloor(z);
+	if (!floor) {
+		return 0;
+	}
+	return floor->masks[mask];
+}
+
+void Map::getFloorBitmap(const Position& topLeft, uint16_t width, uint16_t height, FloorMask_t mask, std::vector<uint64_t>& bitmap) const
+{
+	const size_t rowWords = (width + 63) / 64;
+	bitmap.assign(rowWords * height, 0);
+
+	const uint32_t startX = topLeft.x;
+	const uint32_t endX = std::min<uint32_t>(startX + width, 0x10000);
+	for (uint32_t row = 0; row < height; ++row) {
+		const uint32_t y = topLeft.y + row;
+		if (y > 0xFFFF) {
+			break;
+		}
+
+		uint64_t* rowBits = bitmap.data() + row * rowWords;
+		for (uint32_t blockX = startX & ~FLOOR_MASK; blockX < endX; blockX += FLOOR_SIZE) {
+			const uint32_t bits = (getFloorMask(blockX, y, topLeft.z, mask) >> ((y & FLOOR_MASK) << FLOOR_BITS)) & 0xFF;
+			if (bits == 0) {
+				continue;
+			}
+
+			for (uint32_t offset = 0; offset < FLOOR_SIZE; ++offset) {
+				const uint32_t x = blockX + offset;
+				if ((bits & (1 << offset)) != 0 && x >= startX && x < endX) {
+					const uint32_t column = x - startX;
+					rowBits[column / 64] |= static_cast<uint64_t>(1) << (column % 64);
+				}
+			}
+		}
+	}
+}
+
+void Map::updateFloorMasks(const Tile& tile)
+{
+	const Position& pos = tile.getPosition();
+	if (pos.z >= MAP_MAX_LAYERS) {
+		return;
+	}
+
+	QTreeLeafNode* leaf = getQTNode(pos.x, pos.y);
+	if (!leaf) {
+		return;
+	}
+
+	Floor* floor = leaf->getFloor(pos.z);
+	if (!floor || floor->tiles[pos.x & FLOOR_MASK][pos.y & FLOOR_MASK] != &tile) {
+		// not placed on the map yet, setTile takes care of it
+		return;
+	}
+	floor->updateMasks(pos.x, pos.y, &tile);
+}
+
 bool Map::isSightClear(const Position& fromPos, const Position& toPos, bool floorCheck) const
+{
+	FloorMaskCache cache(FLOORMASK_BLOCKPROJECTILE);
+	return isSightClear(fromPos, toPos, floorCheck, cache);
+}
+
+bool Map::isSightClear(const Position& fromPos, const Position& toPos, bool floorCheck, FloorMaskCache& cache) const
 {
 	if (floorCheck && fromPos.z != toPos.z) {
 		return false;
 	}
 
 	// Cast two converging rays and see if either yields a result.
-	return checkSightLine(fromPos, toPos) || checkSightLine(toPos, fromPos);
+	return checkSightLine(fromPos, toPos, cache) || checkSightLine(toPos, fromPos, cache);
+}
+
+void Map::isSightClear(const SightCheckVector& checks, bool floorCheck, std::vector<bool>& results) const
+{
+	FloorMaskCache cache(FLOORMASK_BLOCKPROJECTILE);
+
+	results.clear();
+	results.reserve(checks.size());
+	for (const SightCheck& check : checks) {
+		results.push_back(isSightClear(check.first, check.second, floorCheck, cache));
+	}
 }
 
 const Tile* Map::canWalkTo(const Creature& creature, const Position& pos) const
@@ -855,6 +1135,19 @@ int_fast32_t AStarNodes::getTileWalkCost(const Creature& creature, const Tile* t
 	return cost;
 }
 
+// FloorMaskCache
+bool FloorMaskCache::isSet(const Map& map, uint16_t x, uint16_t y, uint8_t z)
+{
+	// block coordinates and floor, offset by one so that an empty slot never matches
+	const uint32_t key = ((static_cast<uint32_t>(z) << 26) | (static_cast<uint32_t>(y >> FLOOR_BITS) << 13) | (x >> FLOOR_BITS)) + 1;
+	const size_t index = ((x >> FLOOR_BITS) ^ ((y >> FLOOR_BITS) << 2)) & (CACHE_SIZE - 1);
+	if (keys[index] != key) {
+		keys[index] = key;
+		masks[index] = map.getFloorMask(x, y, z, mask);
+	}
+	return (masks[index] & Floor::getMaskBit(x, y)) != 0;
+}
+
 // Floor
 Floor::~Floor()
 {
@@ -865,6 +1158,32 @@ Floor::~Floor()
 	}
 }
 
+void Floor::updateMasks(uint32_t x, uint32_t y, const Tile* tile)
+{
+	const uint64_t bit = getMaskBit(x, y);
+	for (uint64_t& mask : masks) {
+		mask &= ~bit;
+	}
+
+	if (!tile) {
+		return;
+	}
+
+	masks[FLOORMASK_TILE] |= bit;
+	if (tile->hasFlag(TILESTATE_BLOCKSOLID)) {
+		masks[FLOORMASK_BLOCKSOLID] |= bit;
+	}
+	if (tile->hasFlag(TILESTATE_BLOCKPATH)) {
+		masks[FLOORMASK_BLOCKPATH] |= bit;
+	}
+	if (tile->hasFlag(TILESTATE_BLOCKPROJECTILE)) {
+		masks[FLOORMASK_BLOCKPROJECTILE] |= bit;
+	}
+	if (tile->hasFlag(TILESTATE_MAGICFIELD)) {
+		masks[FLOORMASK_MAGICFIELD] |= bit;
+	}
+}
+
 // QTreeNode
 QTreeNode::~QTreeNode()
 {
@@ -1013,3 +1332,27 @@ uint32_t Map::clean() const
 	          << (OTSYS_TIME() - start) / (1000.) << " seconds." << std::endl;
 	return count;
 }
+
+Tile* PlaceholderTile::create(Map& map, const Position& position)
+{
+	release();
+
+	this->map = &map;
+	tile = new StaticTile(position.x, position.y, position.z);
+	tile->setFlag(TILESTATE_EPHEMERAL);
+	return tile;
+}
+
+void PlaceholderTile::release()
+{
+	if (!tile) {
+		return;
+	}
+
+	if (tile->getThingCount() != 0) {
+		map->setTile(tile->getPosition(), tile);
+	} else {
+		delete tile;
+	}
+	tile = nullptr;
+}
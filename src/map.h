@@ -79,6 +79,16 @@ static constexpr int32_t FLOOR_BITS = 3;
 static constexpr int32_t FLOOR_SIZE = (1 << FLOOR_BITS);
 static constexpr int32_t FLOOR_MASK = (FLOOR_SIZE - 1);
 
+enum FloorMask_t : uint8_t {
+	FLOORMASK_TILE,
+	FLOORMASK_BLOCKSOLID,
+	FLOORMASK_BLOCKPATH,
+	FLOORMASK_BLOCKPROJECTILE,
+	FLOORMASK_MAGICFIELD,
+
+	FLOORMASK_LAST
+};
+
 struct Floor {
 	constexpr Floor() = default;
 	~Floor();
@@ -87,9 +97,37 @@ struct Floor {
 	Floor(const Floor&) = delete;
 	Floor& operator=(const Floor&) = delete;
 
+	static uint64_t getMaskBit(uint32_t x, uint32_t y) {
+		return static_cast<uint64_t>(1) << (((y & FLOOR_MASK) << FLOOR_BITS) | (x & FLOOR_MASK));
+	}
+	void updateMasks(uint32_t x, uint32_t y, const Tile* tile);
+
 	Tile* tiles[FLOOR_SIZE][FLOOR_SIZE] = {};
+
+	// One bit per tile (bit y * FLOOR_SIZE + x), mirroring the TILESTATE_MAPMASK tile flags
+	uint64_t masks[FLOORMASK_LAST] = {};
+};
+
+// Small direct-mapped cache of floor masks, shared by the sight line
+// checks of a batch so lines crossing the same blocks reuse the lookups.
+class FloorMaskCache
+{
+	public:
+		explicit FloorMaskCache(FloorMask_t mask) : mask(mask) {}
+
+		bool isSet(const Map& map, uint16_t x, uint16_t y, uint8_t z);
+
+	private:
+		static constexpr size_t CACHE_SIZE = 16;
+
+		uint32_t keys[CACHE_SIZE] = {};
+		uint64_t masks[CACHE_SIZE] = {};
+		FloorMask_t mask;
 };
 
+using SightCheck = std::pair<Position, Position>;
+using SightCheckVector = std::vector<SightCheck>;
+
 class FrozenPathingConditionCall;
 class QTreeLeafNode;
 
@@ -175,6 +213,7 @@ class Map
 	public:
 		static constexpr int32_t maxViewportX = 11; //min value: maxClientViewportX + 1
 		static constexpr int32_t maxViewportY = 11; //min value: maxClientViewportY + 1
+		static constexpr int32_t regionSizeBits = 5; //regionSize has to exceed the view range plus the floor offsets
 		static constexpr int32_t maxClientViewportX = 8;
 		static constexpr int32_t maxClientViewportY = 6;
 
@@ -209,6 +248,23 @@ class Map
 			setTile(pos.x, pos.y, pos.z, newTile);
 		}
 
+		/**
+		  * Get the number of tiles in the map, to follow its growth over the uptime.
+		  */
+		size_t getTileCount() const {
+			return tileCount;
+		}
+
+		/**
+		  * Removes the empty tiles area effects created from the next blocks of the
+		  * map, a full pass is spread over many calls. Tiles with an open browse
+		  * field are kept.
+		  * \param blocks Number of 8x8 blocks to check
+		  * \param passCompleted Set to true when the call finished a pass over the map
+		  * \returns The number of tiles removed
+		  */
+		uint32_t compactEmptyTiles(uint32_t blocks, bool& passCompleted);
+
 		/**
 		  * Place a creature on the map
 		  * \param centerPos The position to place the creature
@@ -224,9 +280,34 @@ class Map
 		                   int32_t minRangeX = 0, int32_t maxRangeX = 0,
 		                   int32_t minRangeY = 0, int32_t maxRangeY = 0);
 
+		/**
+		  * Checks if a creature at spectatorPos is found by getSpectators around centerPos with the default ranges
+		  */
+		static bool isSpectatorOf(const Position& centerPos, const Position& spectatorPos, bool multifloor);
+
 		void clearSpectatorCache();
 		void clearPlayersSpectatorCache();
 
+		/**
+		  * Checks if a player is in the region of the position or in one around it.
+		  * Regions span regionSize tiles on all floors, more than anyone can see.
+		  */
+		bool isRegionActive(const Position& pos) const;
+		void addRegionPlayer(const Position& pos);
+		void removeRegionPlayer(const Position& pos);
+
+		/**
+		  * Parks a creature of an inactive region until a player comes close,
+		  * Game::addCreatureCheck is called for it then.
+		  */
+		void addSleeper(Creature* creature);
+		void removeSleeper(Creature* creature);
+
+		// changes whenever a player is added to or removed from a tile
+		uint32_t getPlayersSpectatorEpoch() const {
+			return playersSpectatorEpoch;
+		}
+
 		/**
 		  * Checks if you can throw an object to that position
 		  *	\param fromPos from Source point
@@ -250,6 +331,37 @@ class Map
 		bool isSightClear(const Position& fromPos, const Position& toPos, bool floorCheck) const;
 		bool checkSightLine(const Position& fromPos, const Position& toPos) const;
 
+		/**
+		  * Checks many lines of sight at once, sharing the floor mask lookups between them.
+		  *	\param checks (from, to) position pairs
+		  *	\param floorCheck if true then view is not clear if from.z is not the same as to.z
+		  *	\param results Receives one entry per check, true if the sight is clear
+		  */
+		void isSightClear(const SightCheckVector& checks, bool floorCheck, std::vector<bool>& results) const;
+
+		/**
+		  * Checks one line of sight of a batch, the caller keeps the cache between the checks.
+		  */
+		bool isSightClear(const Position& fromPos, const Position& toPos, bool floorCheck, FloorMaskCache& cache) const;
+
+		/**
+		  * Get the summary bitmap of the 8x8 block containing a position.
+		  * \returns One bit per tile (bit y * FLOOR_SIZE + x), 0 if the block has no tiles
+		  */
+		uint64_t getFloorMask(uint16_t x, uint16_t y, uint8_t z, FloorMask_t mask) const;
+
+		/**
+		  * Copies a summary bitmap of a rectangular area into rows of 64-bit words,
+		  * one bit per tile, for bulk scans over a floor.
+		  *	\param topLeft North-west corner of the area
+		  *	\param width Width of the area in tiles
+		  *	\param height Height of the area in tiles
+		  *	\param bitmap Receives height rows of (width + 63) / 64 words
+		  */
+		void getFloorBitmap(const Position& topLeft, uint16_t width, uint16_t height, FloorMask_t mask, std::vector<uint64_t>& bitmap) const;
+
+		void updateFloorMasks(const Tile& tile);
+
 		const Tile* canWalkTo(const Creature& creature, const Position& pos) const;
 
 		bool getPathMatching(const Creature& creature, std::forward_list<Direction>& dirList,
@@ -265,9 +377,18 @@ class Map
 		Towns towns;
 		Houses houses;
 
+		static uint32_t getRegionKey(uint32_t regionX, uint32_t regionY) {
+			return (regionX << 16) | regionY;
+		}
+
 	private:
+
+		std::unordered_map<uint32_t, uint32_t> regionPlayers;
+		std::unordered_map<uint32_t, std::vector<Creature*>> regionSleepers;
+
 		SpectatorCache spectatorCache;
 		SpectatorCache playersSpectatorCache;
+		uint32_t playersSpectatorEpoch = 0;
 
 		QTreeNode root;
 
@@ -277,6 +398,13 @@ class Map
 		uint32_t width = 0;
 		uint32_t height = 0;
 
+		size_t tileCount = 0;
+		uint32_t compactionCursor = 0;
+
+		bool checkSightLine(const Position& fromPos, const Position& toPos, FloorMaskCache& cache) const;
+
+		static void getSpectatorFloors(const Position& centerPos, bool multifloor, int32_t& minRangeZ, int32_t& maxRangeZ);
+
 		// Actually scans the map for spectators
 		void getSpectatorsInternal(SpectatorVec& spectators, const Position& centerPos,
 		                           int32_t minRangeX, int32_t maxRangeX,
@@ -287,4 +415,27 @@ class Map
 		friend class IOMap;
 };
 
+// Stands in for a position of the map without tile where a Tile has to be
+// handed to checks or scripts. It is not added to the map and is deleted
+// again on release, unless something was put on it; then it joins the map.
+class PlaceholderTile
+{
+	public:
+		PlaceholderTile() = default;
+		~PlaceholderTile() {
+			release();
+		}
+
+		// non-copyable
+		PlaceholderTile(const PlaceholderTile&) = delete;
+		PlaceholderTile& operator=(const PlaceholderTile&) = delete;
+
+		Tile* create(Map& map, const Position& position);
+		void release();
+
+	private:
+		Map* map = nullptr;
+		Tile* tile = nullptr;
+};
+
 #endif
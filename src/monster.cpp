@@ -82,7 +82,7 @@ void Monster::removeList()
 
 bool Monster::canSee(const Position& pos) const
 {
-	return Creature::canSee(getPosition(), pos, 9, 9);
+	return Creature::canSee(getPosition(), pos, viewRangeX, viewRangeY);
 }
 
 bool Monster::canWalkOnFieldType(CombatType_t combatType) const
@@ -178,7 +178,7 @@ void Monster::onRemoveCreature(Creature* creature, bool isLogout)
 
 	if (creature == this) {
 		if (spawn) {
-			spawn->startSpawnCheck();
+			spawn->removeMonster(this);
 		}
 
 		setIdle(true);
@@ -225,8 +225,17 @@ void Monster::onCreatureMove(Creature* creature, const Tile* newTile, const Posi
 			isMasterInRange = canSee(getMaster()->getPosition());
 		}
 
-		updateTargetList();
+		if (!teleport && oldPos.z == newPos.z && Position::getDistanceX(oldPos, newPos) <= 1 && Position::getDistanceY(oldPos, newPos) <= 1) {
+			updateTargetList(oldPos);
+		} else {
+			updateTargetList();
+		}
 		updateIdleStatus();
+
+		// a lured monster frees its spawn slot as soon as it leaves the zone
+		if (spawn && spawn->isInSpawnZone(oldPos) && !spawn->isInSpawnZone(newPos)) {
+			spawn->cleanup();
+		}
 	} else {
 		bool canSeeNewPos = canSee(newPos);
 		bool canSeeOldPos = canSee(oldPos);
@@ -325,7 +334,7 @@ void Monster::addTarget(Creature* creature, bool pushFront/* = false*/)
 	if (std::find(targetList.begin(), targetList.end(), creature) == targetList.end()) {
 		creature->incrementReferenceCounter();
 		if (pushFront) {
-			targetList.push_front(creature);
+			targetList.insert(targetList.begin(), creature);
 		} else {
 			targetList.push_back(creature);
 		}
@@ -342,6 +351,52 @@ void Monster::removeTarget(Creature* creature)
 }
 
 void Monster::updateTargetList()
+{
+	removeUnseenCreatures();
+
+	SpectatorVec spectators;
+	g_game.map.getSpectators(spectators, position, true);
+	spectators.erase(this);
+	for (Creature* spectator : spectators) {
+		if (canSee(spectator->getPosition())) {
+			onCreatureFound(spectator);
+		}
+	}
+}
+
+void Monster::updateTargetList(const Position& oldPos)
+{
+	removeUnseenCreatures();
+
+	// a single step only reveals the column and the row at the edge of the
+	// view it moved towards, everyone else was already found before; the
+	// spectator search shifts the strip by the floor offset like canSee
+	const int32_t stepX = position.getX() - oldPos.getX();
+	const int32_t stepY = position.getY() - oldPos.getY();
+
+	SpectatorVec spectators;
+	if (stepX != 0) {
+		const int32_t edgeX = stepX * viewRangeX;
+		g_game.map.getSpectators(spectators, position, true, false, -edgeX, edgeX, viewRangeY, viewRangeY);
+	}
+
+	if (stepY != 0) {
+		const int32_t edgeY = stepY * viewRangeY;
+
+		SpectatorVec rowSpectators;
+		g_game.map.getSpectators(rowSpectators, position, true, false, viewRangeX, viewRangeX, -edgeY, edgeY);
+		spectators.addSpectators(rowSpectators);
+	}
+
+	spectators.erase(this);
+	for (Creature* spectator : spectators) {
+		if (canSee(spectator->getPosition())) {
+			onCreatureFound(spectator);
+		}
+	}
+}
+
+void Monster::removeUnseenCreatures()
 {
 	auto friendIterator = friendList.begin();
 	while (friendIterator != friendList.end()) {
@@ -364,15 +419,6 @@ void Monster::updateTargetList()
 			++targetIterator;
 		}
 	}
-
-	SpectatorVec spectators;
-	g_game.map.getSpectators(spectators, position, true);
-	spectators.erase(this);
-	for (Creature* spectator : spectators) {
-		if (canSee(spectator->getPosition())) {
-			onCreatureFound(spectator);
-		}
-	}
 }
 
 void Monster::clearTargetList()
@@ -483,53 +529,40 @@ void Monster::onCreatureLeave(Creature* creature)
 
 bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAULT*/)
 {
-	std::list<Creature*> resultList;
 	const Position& myPos = getPosition();
 
+	// a single pass collects the candidates along with the nearest one of
+	// them, and the nearest of all targets in case none can be attacked
+	SmallVector<Creature*, 8> resultList;
+	Creature* nearest = nullptr;
+	Creature* nearestTarget = nullptr;
+	int32_t minRange = std::numeric_limits<int32_t>::max();
+	int32_t minTargetRange = std::numeric_limits<int32_t>::max();
+
 	for (Creature* creature : targetList) {
-		if (followCreature != creature && isTarget(creature)) {
-			if (searchType == TARGETSEARCH_RANDOM || canUseAttack(myPos, creature)) {
-				resultList.push_back(creature);
+		if (!isTarget(creature)) {
+			continue;
+		}
+
+		const Position& pos = creature->getPosition();
+		const int32_t distance = Position::getDistanceX(myPos, pos) + Position::getDistanceY(myPos, pos);
+		if (distance < minTargetRange) {
+			nearestTarget = creature;
+			minTargetRange = distance;
+		}
+
+		if (followCreature != creature && (searchType == TARGETSEARCH_RANDOM || canUseAttack(myPos, creature))) {
+			resultList.push_back(creature);
+			if (distance < minRange) {
+				nearest = creature;
+				minRange = distance;
 			}
 		}
 	}
 
 	switch (searchType) {
 		case TARGETSEARCH_NEAREST: {
-			Creature* target = nullptr;
-			if (!resultList.empty()) {
-				auto it = resultList.begin();
-				target = *it;
-
-				if (++it != resultList.end()) {
-					const Position& targetPosition = target->getPosition();
-					int32_t minRange = Position::getDistanceX(myPos, targetPosition) + Position::getDistanceY(myPos, targetPosition);
-					do {
-						const Position& pos = (*it)->getPosition();
-
-						int32_t distance = Position::getDistanceX(myPos, pos) + Position::getDistanceY(myPos, pos);
-						if (distance < minRange) {
-							target = *it;
-							minRange = distance;
-						}
-					} while (++it != resultList.end());
-				}
-			} else {
-				int32_t minRange = std::numeric_limits<int32_t>::max();
-				for (Creature* creature : targetList) {
-					if (!isTarget(creature)) {
-						continue;
-					}
-
-					const Position& pos = creature->getPosition();
-					int32_t distance = Position::getDistanceX(myPos, pos) + Position::getDistanceY(myPos, pos);
-					if (distance < minRange) {
-						target = creature;
-						minRange = distance;
-					}
-				}
-			}
-
+			Creature* target = resultList.empty() ? nearestTarget : nearest;
 			if (target && selectTarget(target)) {
 				return true;
 			}
@@ -541,9 +574,7 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 		case TARGETSEARCH_RANDOM:
 		default: {
 			if (!resultList.empty()) {
-				auto it = resultList.begin();
-				std::advance(it, uniform_random(0, resultList.size() - 1));
-				return selectTarget(*it);
+				return selectTarget(resultList[uniform_random(0, resultList.size() - 1)]);
 			}
 
 			if (searchType == TARGETSEARCH_ATTACKRANGE) {
@@ -568,15 +599,13 @@ void Monster::onFollowCreatureComplete(const Creature* creature)
 	if (creature) {
 		auto it = std::find(targetList.begin(), targetList.end(), creature);
 		if (it != targetList.end()) {
-			Creature* target = (*it);
-			targetList.erase(it);
-
 			if (hasFollowPath) {
-				targetList.push_front(target);
+				std::rotate(targetList.begin(), it, it + 1);
 			} else if (!isSummon()) {
-				targetList.push_back(target);
+				std::rotate(it, it + 1, targetList.end());
 			} else {
-				target->decrementReferenceCounter();
+				(*it)->decrementReferenceCounter();
+				targetList.erase(it);
 			}
 		}
 	}
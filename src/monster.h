@@ -22,13 +22,14 @@
 
 #include "tile.h"
 #include "monsters.h"
+#include "smallvector.h"
 
 class Creature;
 class Game;
 class Spawn;
 
 using CreatureHashSet = std::unordered_set<Creature*>;
-using CreatureList = std::list<Creature*>;
+using CreatureList = SmallVector<Creature*, 8>;
 
 enum TargetSearchType_t {
 	TARGETSEARCH_DEFAULT,
@@ -44,6 +45,10 @@ class Monster final : public Creature
 		static int32_t despawnRange;
 		static int32_t despawnRadius;
 
+		// how far monsters see, narrower than the player viewport
+		static constexpr int32_t viewRangeX = 9;
+		static constexpr int32_t viewRangeY = 9;
+
 		explicit Monster(MonsterType* mType);
 		~Monster();
 
@@ -220,6 +225,8 @@ class Monster final : public Creature
 		void removeTarget(Creature* creature);
 
 		void updateTargetList();
+		void updateTargetList(const Position& oldPos);
+		void removeUnseenCreatures();
 		void clearTargetList();
 		void clearFriendList();
 
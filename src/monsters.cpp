@@ -56,6 +56,73 @@ void MonsterType::loadLoot(MonsterType* monsterType, LootBlock lootBlock)
 	}
 }
 
+bool MonsterType::createLoot(Container* corpse) const
+{
+	bool success = true;
+	for (const LootBlock& lootBlock : info.lootItems) {
+		if (!createLootItem(corpse, lootBlock)) {
+			success = false;
+		}
+	}
+	return success;
+}
+
+bool MonsterType::createLootItem(Container* parent, const LootBlock& lootBlock)
+{
+	if (parent->size() >= parent->capacity()) {
+		return true;
+	}
+
+	const uint32_t rateLoot = g_config.getNumber(ConfigManager::RATE_LOOT);
+	if (rateLoot == 0) {
+		return true;
+	}
+
+	const uint32_t randvalue = uniform_random(0, MAX_LOOTCHANCE) / rateLoot;
+	if (randvalue >= lootBlock.chance) {
+		return true;
+	}
+
+	uint16_t itemCount = 1;
+	if (Item::items[lootBlock.id].stackable) {
+		itemCount = std::min<uint32_t>(randvalue % std::max<uint32_t>(lootBlock.countmax, 1) + 1, 100);
+	}
+
+	Item* item = Item::CreateItem(lootBlock.id, itemCount);
+	if (!item) {
+		return false;
+	}
+
+	if (lootBlock.subType != -1) {
+		item->setIntAttr(ITEM_ATTRIBUTE_CHARGES, lootBlock.subType);
+	}
+
+	if (lootBlock.actionId != -1) {
+		item->setActionId(lootBlock.actionId);
+	}
+
+	if (!lootBlock.text.empty()) {
+		item->setText(lootBlock.text);
+	}
+
+	// fill the container before it is put in the corpse, so a single
+	// notification covers the whole tree
+	if (Container* container = item->getContainer()) {
+		for (const LootBlock& childBlock : lootBlock.childLoot) {
+			if (!createLootItem(container, childBlock)) {
+				delete item;
+				return false;
+			}
+		}
+	}
+
+	if (g_game.internalAddItem(parent, item) != RETURNVALUE_NOERROR) {
+		delete item;
+		return false;
+	}
+	return true;
+}
+
 bool Monsters::loadFromXml(bool reloading /*= false*/)
 {
 	unloadedMonsters = {};
@@ -177,6 +177,12 @@ class MonsterType
 		MonsterInfo info;
 
 		void loadLoot(MonsterType* monsterType, LootBlock lootblock);
+
+		// rolls the loot list into the corpse, false if a rolled item did not fit
+		bool createLoot(Container* corpse) const;
+
+	private:
+		static bool createLootItem(Container* parent, const LootBlock& lootBlock);
 };
 
 class MonsterSpell
@@ -32,6 +32,7 @@ MoveEvents::MoveEvents() :
 	scriptInterface("MoveEvents Interface")
 {
 	scriptInterface.initState();
+	scriptInterface.setBudgetConfig(ConfigManager::SCRIPT_BUDGET_MOVEEVENTS);
 }
 
 MoveEvents::~MoveEvents()
@@ -77,10 +78,51 @@ void MoveEvents::clear(bool fromLua)
 	clearMap(actionIdMap, fromLua);
 	clearMap(uniqueIdMap, fromLua);
 	clearPosMap(positionMap, fromLua);
+	indexesDirty = true;
 
 	reInitState(fromLua);
 }
 
+void MoveEvents::buildIndexes()
+{
+	itemIdIndex.assign(itemIdMap.empty() ? 0 : std::max<int32_t>(0, itemIdMap.rbegin()->first + 1), nullptr);
+	for (auto& it : itemIdMap) {
+		if (it.first >= 0) {
+			itemIdIndex[it.first] = &it.second;
+		}
+	}
+
+	uniqueIdIndex.clear();
+	for (auto& it : uniqueIdMap) {
+		uniqueIdIndex.emplace(it.first, &it.second);
+	}
+
+	actionIdIndex.clear();
+	for (auto& it : actionIdMap) {
+		actionIdIndex.emplace(it.first, &it.second);
+	}
+
+	positionIndex.clear();
+	for (auto& it : positionMap) {
+		positionIndex.emplace(it.first, &it.second);
+	}
+	indexesDirty = false;
+}
+
+bool MoveEvents::hasItemEvents(const Item* item)
+{
+	if (item->hasAttribute(ITEM_ATTRIBUTE_UNIQUEID) || item->hasAttribute(ITEM_ATTRIBUTE_ACTIONID)) {
+		return true;
+	}
+
+	if (indexesDirty) {
+		buildIndexes();
+	}
+
+	const uint16_t itemId = item->getID();
+	return itemId < itemIdIndex.size() && itemIdIndex[itemId];
+}
+
 LuaScriptInterface& MoveEvents::getScriptInterface()
 {
 	return scriptInterface;
@@ -289,8 +331,14 @@ bool MoveEvents::registerLuaEvent(MoveEvent* event)
 
 void MoveEvents::addEvent(MoveEvent moveEvent, int32_t id, MoveListMap& map)
 {
+	indexesDirty = true;
+
 	auto it = map.find(id);
 	if (it == map.end()) {
+		if (&map == &itemIdMap && g_game.getGameState() != GAME_STATE_STARTUP) {
+			tileFlagsReliable = false;
+		}
+
 		MoveEventList moveEventList;
 		moveEventList.moveEvent[moveEvent.getEventType()].push_back(std::move(moveEvent));
 		map[id] = moveEventList;
@@ -322,9 +370,13 @@ MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType, slots_t slot)
 		default: slotp = 0; break;
 	}
 
-	auto it = itemIdMap.find(item->getID());
-	if (it != itemIdMap.end()) {
-		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
+	if (indexesDirty) {
+		buildIndexes();
+	}
+
+	const uint16_t itemId = item->getID();
+	if (itemId < itemIdIndex.size() && itemIdIndex[itemId]) {
+		std::list<MoveEvent>& moveEventList = itemIdIndex[itemId]->moveEvent[eventType];
 		for (MoveEvent& moveEvent : moveEventList) {
 			if ((moveEvent.getSlot() & slotp) != 0) {
 				return &moveEvent;
@@ -336,33 +388,33 @@ MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType, slots_t slot)
 
 MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType)
 {
-	MoveListMap::iterator it;
+	if (indexesDirty) {
+		buildIndexes();
+	}
 
 	if (item->hasAttribute(ITEM_ATTRIBUTE_UNIQUEID)) {
-		it = uniqueIdMap.find(item->getUniqueId());
-		if (it != uniqueIdMap.end()) {
-			std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
-			if (!moveEventList.empty()) {
-				return &(*moveEventList.begin());
+		if (MoveEventList** moveEventList = uniqueIdIndex.find(item->getUniqueId())) {
+			std::list<MoveEvent>& moveEvents = (*moveEventList)->moveEvent[eventType];
+			if (!moveEvents.empty()) {
+				return &(*moveEvents.begin());
 			}
 		}
 	}
 
 	if (item->hasAttribute(ITEM_ATTRIBUTE_ACTIONID)) {
-		it = actionIdMap.find(item->getActionId());
-		if (it != actionIdMap.end()) {
-			std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
-			if (!moveEventList.empty()) {
-				return &(*moveEventList.begin());
+		if (MoveEventList** moveEventList = actionIdIndex.find(item->getActionId())) {
+			std::list<MoveEvent>& moveEvents = (*moveEventList)->moveEvent[eventType];
+			if (!moveEvents.empty()) {
+				return &(*moveEvents.begin());
 			}
 		}
 	}
 
-	it = itemIdMap.find(item->getID());
-	if (it != itemIdMap.end()) {
-		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
-		if (!moveEventList.empty()) {
-			return &(*moveEventList.begin());
+	const uint16_t itemId = item->getID();
+	if (itemId < itemIdIndex.size() && itemIdIndex[itemId]) {
+		std::list<MoveEvent>& moveEvents = itemIdIndex[itemId]->moveEvent[eventType];
+		if (!moveEvents.empty()) {
+			return &(*moveEvents.begin());
 		}
 	}
 	return nullptr;
@@ -370,6 +422,8 @@ MoveEvent* MoveEvents::getEvent(Item* item, MoveEvent_t eventType)
 
 void MoveEvents::addEvent(MoveEvent moveEvent, const Position& pos, MovePosListMap& map)
 {
+	indexesDirty = true;
+
 	auto it = map.find(pos);
 	if (it == map.end()) {
 		MoveEventList moveEventList;
@@ -387,11 +441,14 @@ void MoveEvents::addEvent(MoveEvent moveEvent, const Position& pos, MovePosListM
 
 MoveEvent* MoveEvents::getEvent(const Tile* tile, MoveEvent_t eventType)
 {
-	auto it = positionMap.find(tile->getPosition());
-	if (it != positionMap.end()) {
-		std::list<MoveEvent>& moveEventList = it->second.moveEvent[eventType];
-		if (!moveEventList.empty()) {
-			return &(*moveEventList.begin());
+	if (indexesDirty) {
+		buildIndexes();
+	}
+
+	if (MoveEventList** moveEventList = positionIndex.find(tile->getPosition())) {
+		std::list<MoveEvent>& moveEvents = (*moveEventList)->moveEvent[eventType];
+		if (!moveEvents.empty()) {
+			return &(*moveEvents.begin());
 		}
 	}
 	return nullptr;
@@ -408,6 +465,11 @@ uint32_t MoveEvents::onCreatureMove(Creature* creature, const Tile* tile, MoveEv
 		ret &= moveEvent->fireStepEvent(creature, nullptr, pos);
 	}
 
+	// plain steps, none of the items on the tile can have an event
+	if (tileFlagsReliable && !tile->hasFlag(TILESTATE_MOVEEVENT)) {
+		return ret;
+	}
+
 	for (size_t i = tile->getFirstIndex(), j = tile->getLastIndex(); i < j; ++i) {
 		Thing* thing = tile->getThing(i);
 		if (!thing) {
@@ -467,6 +529,10 @@ uint32_t MoveEvents::onItemMove(Item* item, Tile* tile, bool isAdd)
 		ret &= moveEvent->fireAddRemItem(item, nullptr, tile->getPosition());
 	}
 
+	if (tileFlagsReliable && !tile->hasFlag(TILESTATE_MOVEEVENT)) {
+		return ret;
+	}
+
 	for (size_t i = tile->getFirstIndex(), j = tile->getLastIndex(); i < j; ++i) {
 		Thing* thing = tile->getThing(i);
 		if (!thing) {
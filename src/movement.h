@@ -21,6 +21,7 @@
 #define FS_MOVEMENT_H_5E0D2626D4634ACA83AC6509518E5F49
 
 #include "baseevents.h"
+#include "flathashmap.h"
 #include "item.h"
 #include "luascript.h"
 #include "vocation.h"
@@ -67,6 +68,10 @@ class MoveEvents final : public BaseEvents
 
 		MoveEvent* getEvent(Item* item, MoveEvent_t eventType);
 
+		// true if the item may have a move event by its id, unique id or action id,
+		// tiles keep TILESTATE_MOVEEVENT while they hold such an item
+		bool hasItemEvents(const Item* item);
+
 		bool registerLuaEvent(MoveEvent* event);
 		bool registerLuaFunction(MoveEvent* event);
 		void clear(bool fromLua) override final;
@@ -94,6 +99,19 @@ class MoveEvents final : public BaseEvents
 		MoveListMap itemIdMap;
 		MovePosListMap positionMap;
 
+		// lookup indexes into the maps above, rebuilt after they change
+		std::vector<MoveEventList*> itemIdIndex;
+		FlatHashMap<int32_t, MoveEventList*> uniqueIdIndex;
+		FlatHashMap<int32_t, MoveEventList*> actionIdIndex;
+		FlatHashMap<Position, MoveEventList*> positionIndex;
+		bool indexesDirty = true;
+
+		// cleared once an item id gets its first event after the map was
+		// loaded, the TILESTATE_MOVEEVENT flags may then be missing
+		bool tileFlagsReliable = true;
+
+		void buildIndexes();
+
 		LuaScriptInterface scriptInterface;
 };
 
@@ -563,6 +563,7 @@ NpcScriptInterface::NpcScriptInterface() :
 {
 	libLoaded = false;
 	initState();
+	setBudgetConfig(ConfigManager::SCRIPT_BUDGET_NPC);
 }
 
 bool NpcScriptInterface::initState()
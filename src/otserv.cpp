@@ -35,11 +35,13 @@
 #include "scheduler.h"
 #include "databasetasks.h"
 #include "script.h"
+#include "watchdog.h"
 #include <fstream>
 
 DatabaseTasks g_databaseTasks;
 Dispatcher g_dispatcher;
 Scheduler g_scheduler;
+Watchdog g_watchdog;
 
 Game g_game;
 ConfigManager g_config;
@@ -77,6 +79,7 @@ int main(int argc, char* argv[])
 
 	g_dispatcher.start();
 	g_scheduler.start();
+	g_watchdog.start();
 
 	g_dispatcher.addTask(createTask(std::bind(mainLoader, argc, argv, &serviceManager)));
 
@@ -95,6 +98,9 @@ int main(int argc, char* argv[])
 	g_scheduler.join();
 	g_databaseTasks.join();
 	g_dispatcher.join();
+
+	g_watchdog.shutdown();
+	g_watchdog.join();
 	return 0;
 }
 
@@ -148,6 +154,9 @@ void mainLoader(int, char*[], ServiceManager* services)
 		return;
 	}
 
+	setRandomSeed(std::max<int32_t>(g_config.getNumber(ConfigManager::RANDOM_SEED), 0));
+	std::cout << ">> Random seed: " << getRandomSeed() << std::endl;
+
 #ifdef _WIN32
 	const std::string& defaultPriority = g_config.getString(ConfigManager::DEFAULT_PRIORITY);
 	if (strcasecmp(defaultPriority.c_str(), "high") == 0) {
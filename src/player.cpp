@@ -385,6 +385,26 @@ float Player::getDefenseFactor() const
 	}
 }
 
+void Player::removePersistentConditions()
+{
+	ConditionStore::Iteration iteration(conditions);
+	for (size_t i = 0; i < conditions.size(); ++i) {
+		Condition* condition = conditions[i];
+		if (!condition || !condition->isPersistent()) {
+			continue;
+		}
+
+		conditions.remove(condition);
+
+		condition->endCondition(this);
+		onEndCondition(condition->getType());
+		delete condition;
+	}
+
+	// cooldowns are persistent as well
+	cooldowns.clear();
+}
+
 uint16_t Player::getClientIcons() const
 {
 	uint16_t icons = 0;
@@ -629,6 +649,12 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 				value >> 16,
 				value & 0xFF
 			);
+
+			// keep the stored key, the first save has to know it to drop
+			// the rows of outfits removed in this session
+			if (isLogin) {
+				storageMap.load(key, value);
+			}
 			return;
 		} else if (IS_IN_KEYRANGE(key, MOUNTS_RANGE)) {
 			// do nothing
@@ -639,17 +665,20 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 	}
 
 	if (value != -1) {
+		if (isLogin) {
+			storageMap.load(key, value);
+			return;
+		}
+
 		int32_t oldValue;
 		getStorageValue(key, oldValue);
 
-		storageMap[key] = value;
+		storageMap.set(key, value);
 
-		if (!isLogin) {
-			auto currentFrameTime = g_dispatcher.getDispatcherCycle();
-			if (lastQuestlogUpdate != currentFrameTime && g_game.quests.isQuestStorage(key, value, oldValue)) {
-				lastQuestlogUpdate = currentFrameTime;
-				sendTextMessage(MESSAGE_EVENT_ADVANCE, "Your questlog has been updated.");
-			}
+		auto currentFrameTime = g_dispatcher.getDispatcherCycle();
+		if (lastQuestlogUpdate != currentFrameTime && g_game.quests.isQuestStorage(key, value, oldValue)) {
+			lastQuestlogUpdate = currentFrameTime;
+			sendTextMessage(MESSAGE_EVENT_ADVANCE, "Your questlog has been updated.");
 		}
 	} else {
 		storageMap.erase(key);
@@ -658,13 +687,13 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 
 bool Player::getStorageValue(const uint32_t key, int32_t& value) const
 {
-	auto it = storageMap.find(key);
-	if (it == storageMap.end()) {
+	const int32_t* storedValue = storageMap.find(key);
+	if (!storedValue) {
 		value = -1;
 		return false;
 	}
 
-	value = it->second;
+	value = *storedValue;
 	return true;
 }
 
@@ -2027,35 +2056,11 @@ void Player::death(Creature* lastHitCreature)
 			mana = manaMax;
 		}
 
-		auto it = conditions.begin(), end = conditions.end();
-		while (it != end) {
-			Condition* condition = *it;
-			if (condition->isPersistent()) {
-				it = conditions.erase(it);
-
-				condition->endCondition(this);
-				onEndCondition(condition->getType());
-				delete condition;
-			} else {
-				++it;
-			}
-		}
+		removePersistentConditions();
 	} else {
 		setSkillLoss(true);
 
-		auto it = conditions.begin(), end = conditions.end();
-		while (it != end) {
-			Condition* condition = *it;
-			if (condition->isPersistent()) {
-				it = conditions.erase(it);
-
-				condition->endCondition(this);
-				onEndCondition(condition->getType());
-				delete condition;
-			} else {
-				++it;
-			}
-		}
+		removePersistentConditions();
 
 		health = healthMax;
 		g_game.internalTeleport(this, getTemplePosition(), true);
@@ -3661,8 +3666,11 @@ void Player::genReservedStorageRange()
 	//generate outfits range
 	uint32_t base_key = PSTRG_OUTFITS_RANGE_START;
 	for (const OutfitEntry& entry : outfits) {
-		storageMap[++base_key] = (entry.lookType << 16) | entry.addons;
+		storageMap.set(++base_key, (entry.lookType << 16) | entry.addons);
 	}
+
+	//drop the keys of outfits removed since the last save
+	storageMap.eraseRange(base_key + 1, PSTRG_OUTFITS_RANGE_START + PSTRG_OUTFITS_RANGE_SIZE);
 }
 
 void Player::addOutfit(uint16_t lookType, uint8_t addons)
@@ -36,6 +36,7 @@
 #include "groups.h"
 #include "town.h"
 #include "mounts.h"
+#include "storagemap.h"
 
 class House;
 class NetworkMessage;
@@ -403,6 +404,9 @@ class Player final : public Creature, public Cylinder
 			return group->access;
 		}
 		bool isPremium() const;
+		int32_t getPremiumDays() const {
+			return premiumDays;
+		}
 		void setPremiumDays(int32_t v);
 
 		uint16_t getHelpers() const;
@@ -1159,6 +1163,7 @@ class Player final : public Creature, public Cylinder
 		void setNextActionTask(SchedulerTask* task);
 
 		void death(Creature* lastHitCreature) override;
+		void removePersistentConditions();
 		bool dropCorpse(Creature* lastHitCreature, Creature* mostDamageCreature, bool lastHitUnjustified, bool mostDamageUnjustified) override;
 		Item* getCorpse(Creature* lastHitCreature, Creature* mostDamageCreature) override;
 
@@ -1195,7 +1200,7 @@ class Player final : public Creature, public Cylinder
 		std::map<uint8_t, OpenContainer> openContainers;
 		std::map<uint32_t, DepotLocker*> depotLockerMap;
 		std::map<uint32_t, DepotChest*> depotChests;
-		std::map<uint32_t, int32_t> storageMap;
+		StorageMap storageMap;
 
 		std::vector<OutfitEntry> outfits;
 		GuildWarVector guildWarVector;
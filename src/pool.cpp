@@ -0,0 +1,58 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "pool.h"
+
+constexpr size_t SlabPoolBase::SLAB_OBJECTS;
+constexpr size_t SlabPoolBase::BULK_SLAB_OBJECTS;
+
+std::atomic<bool> SlabPoolBase::bulkLoad(false);
+
+namespace {
+
+std::mutex poolsLock;
+
+std::vector<SlabPoolBase*>& getPools()
+{
+	// never destroyed, objects may still be released during static destruction
+	static auto pools = new std::vector<SlabPoolBase*>();
+	return *pools;
+}
+
+}
+
+SlabPoolBase::SlabPoolBase(const char* name, bool bulk) : name(name), bulk(bulk)
+{
+	std::lock_guard<std::mutex> lockGuard(poolsLock);
+	getPools().push_back(this);
+}
+
+std::vector<SlabPoolStats> SlabPoolBase::getAllStats()
+{
+	std::lock_guard<std::mutex> lockGuard(poolsLock);
+
+	std::vector<SlabPoolStats> stats;
+	stats.reserve(getPools().size());
+	for (const SlabPoolBase* pool : getPools()) {
+		stats.push_back(pool->getStats());
+	}
+	return stats;
+}
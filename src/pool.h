@@ -0,0 +1,148 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_POOL_H_FEE6BE6622AC4F078AC17C3047331B0E
+#define FS_POOL_H_FEE6BE6622AC4F078AC17C3047331B0E
+
+#include <atomic>
+
+struct SlabPoolStats {
+	const char* name;
+	size_t objectSize;
+	size_t live;
+	size_t free;
+	size_t slabs;
+};
+
+class SlabPoolBase
+{
+	public:
+		virtual ~SlabPoolBase() = default;
+
+		// non-copyable
+		SlabPoolBase(const SlabPoolBase&) = delete;
+		SlabPoolBase& operator=(const SlabPoolBase&) = delete;
+
+		static std::vector<SlabPoolStats> getAllStats();
+
+		// While set, bulk pools grow in large slabs so that the items and
+		// tiles created during map load end up packed together.
+		static void setBulkLoad(bool bulkLoad) {
+			SlabPoolBase::bulkLoad.store(bulkLoad, std::memory_order_relaxed);
+		}
+
+		virtual SlabPoolStats getStats() const = 0;
+
+	protected:
+		SlabPoolBase(const char* name, bool bulk);
+
+		static constexpr size_t SLAB_OBJECTS = 256;
+		static constexpr size_t BULK_SLAB_OBJECTS = 16384;
+
+		static std::atomic<bool> bulkLoad;
+
+		const char* name;
+		const bool bulk;
+};
+
+// Type-segregated free list allocator, used as the class specific
+// operator new/delete of frequently created game objects. Requests
+// for a different size (derived classes) go to the global heap.
+template <typename T>
+class SlabPool final : public SlabPoolBase
+{
+	public:
+		SlabPool(const char* name, bool bulk) : SlabPoolBase(name, bulk) {}
+
+		void* allocate(size_t size) {
+			if (size != sizeof(T)) {
+				return ::operator new(size);
+			}
+
+			std::lock_guard<std::mutex> lockGuard(lock);
+			if (!freeList) {
+				grow();
+			}
+
+			Node* node = freeList;
+			freeList = node->next;
+			--freeCount;
+			++liveCount;
+			return node;
+		}
+
+		void deallocate(void* p, size_t size) {
+			if (!p) {
+				return;
+			}
+
+			if (size != sizeof(T)) {
+				::operator delete(p);
+				return;
+			}
+
+			std::lock_guard<std::mutex> lockGuard(lock);
+			Node* node = static_cast<Node*>(p);
+			node->next = freeList;
+			freeList = node;
+			++freeCount;
+			--liveCount;
+		}
+
+		SlabPoolStats getStats() const final {
+			std::lock_guard<std::mutex> lockGuard(lock);
+			return {name, sizeof(T), liveCount, freeCount, slabs.size()};
+		}
+
+	private:
+		union Node {
+			Node* next;
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		};
+
+		void grow() {
+			const size_t count = bulk && bulkLoad.load(std::memory_order_relaxed) ? BULK_SLAB_OBJECTS : SLAB_OBJECTS;
+			slabs.emplace_back(new Node[count]);
+
+			Node* slab = slabs.back().get();
+			for (size_t i = count; i-- > 0;) {
+				slab[i].next = freeList;
+				freeList = &slab[i];
+			}
+			freeCount += count;
+		}
+
+		std::vector<std::unique_ptr<Node[]>> slabs;
+		Node* freeList = nullptr;
+		size_t liveCount = 0;
+		size_t freeCount = 0;
+		mutable std::mutex lock;
+};
+
+// Returns the pool of T, created by the first call. Only the types the map
+// is made of in bulk (items, static tiles) should pass bulk = true.
+template <typename T>
+SlabPool<T>& getSlabPool(const char* name, bool bulk = false)
+{
+	// never destroyed, objects may still be released during static destruction
+	static auto pool = new SlabPool<T>(name, bulk);
+	return *pool;
+}
+
+#endif
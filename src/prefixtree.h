@@ -0,0 +1,142 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_PREFIXTREE_H_835DF7F82F08465CBE8EB06333B212AD
+#define FS_PREFIXTREE_H_835DF7F82F08465CBE8EB06333B212AD
+
+// Case-insensitive prefix tree mapping words to the objects registered for
+// them. Used to find the talkactions and spells a chat line starts with
+// without comparing it against every registered word.
+template <typename T>
+class PrefixTree
+{
+	public:
+		PrefixTree() {
+			clear();
+		}
+
+		void clear() {
+			nodes.clear();
+			nodes.emplace_back();
+		}
+
+		void insert(const std::string& key, T* value) {
+			uint32_t index = 0;
+			for (char ch : key) {
+				index = addChild(index, toLower(ch));
+			}
+
+			// words only differing in case share a node, keep them in the
+			// order the (case sensitive) registration maps iterate them
+			auto& values = nodes[index].values;
+			auto it = std::upper_bound(values.begin(), values.end(), key, [](const std::string& lhs, const std::pair<std::string, T*>& rhs) {
+				return lhs < rhs.first;
+			});
+			values.emplace(it, key, value);
+		}
+
+		// Calls callback(length, value) for every value whose key is a prefix
+		// of query, shortest keys first, until the callback returns true.
+		template <typename Callback>
+		bool forEachPrefix(const std::string& query, Callback callback) const {
+			uint32_t index = 0;
+			for (size_t length = 0; ; ++length) {
+				const Node& node = nodes[index];
+				for (const auto& it : node.values) {
+					if (callback(length, it.second)) {
+						return true;
+					}
+				}
+
+				if (length == query.length()) {
+					return false;
+				}
+
+				index = getChild(index, toLower(query[length]));
+				if (index == 0) {
+					return false;
+				}
+			}
+		}
+
+		// Returns the value with the longest key that is a prefix of query
+		T* findLongestPrefix(const std::string& query) const {
+			T* result = nullptr;
+
+			uint32_t index = 0;
+			for (size_t length = 0; ; ++length) {
+				const Node& node = nodes[index];
+				if (!node.values.empty()) {
+					result = node.values.front().second;
+				}
+
+				if (length == query.length()) {
+					return result;
+				}
+
+				index = getChild(index, toLower(query[length]));
+				if (index == 0) {
+					return result;
+				}
+			}
+		}
+
+	private:
+		struct Node {
+			// sorted by character, the root (index 0) is never a child so 0 marks a miss
+			std::vector<std::pair<char, uint32_t>> children;
+			std::vector<std::pair<std::string, T*>> values;
+		};
+
+		static char toLower(char ch) {
+			return static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+		}
+
+		uint32_t getChild(uint32_t index, char ch) const {
+			const auto& children = nodes[index].children;
+			auto it = std::lower_bound(children.begin(), children.end(), ch, [](const std::pair<char, uint32_t>& lhs, char rhs) {
+				return lhs.first < rhs;
+			});
+			if (it == children.end() || it->first != ch) {
+				return 0;
+			}
+			return it->second;
+		}
+
+		uint32_t addChild(uint32_t index, char ch) {
+			uint32_t child = getChild(index, ch);
+			if (child != 0) {
+				return child;
+			}
+
+			child = nodes.size();
+			nodes.emplace_back();
+
+			auto& children = nodes[index].children;
+			auto it = std::lower_bound(children.begin(), children.end(), ch, [](const std::pair<char, uint32_t>& lhs, char rhs) {
+				return lhs.first < rhs;
+			});
+			children.emplace(it, ch, child);
+			return child;
+		}
+
+		std::vector<Node> nodes;
+};
+
+#endif
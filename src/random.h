@@ -0,0 +1,134 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_RANDOM_H_BDFC18E656FC4EF4B795E46D3FD7E2C3
+#define FS_RANDOM_H_BDFC18E656FC4EF4B795E46D3FD7E2C3
+
+#include <limits>
+
+// xoshiro256** by David Blackman and Sebastiano Vigna, a small and fast
+// generator usable wherever the standard library expects a
+// UniformRandomBitGenerator. Bounded draws use the upper and lower half of
+// one output for two consecutive values.
+class Xoshiro256
+{
+	public:
+		using result_type = uint64_t;
+
+		explicit Xoshiro256(uint64_t seed = 0) {
+			this->seed(seed);
+		}
+
+		static constexpr result_type min() {
+			return 0;
+		}
+		static constexpr result_type max() {
+			return std::numeric_limits<result_type>::max();
+		}
+
+		void seed(uint64_t seed) {
+			// splitmix64 spreads the seed over the whole state, never all zero
+			for (uint64_t& word : state) {
+				uint64_t z = (seed += 0x9E3779B97F4A7C15);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+				word = z ^ (z >> 31);
+			}
+			hasSpare = false;
+		}
+
+		result_type operator()() {
+			const uint64_t result = rotl(state[1] * 5, 7) * 9;
+			const uint64_t t = state[1] << 17;
+
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+
+			state[2] ^= t;
+			state[3] = rotl(state[3], 45);
+			return result;
+		}
+
+		// advances the state by 2^128 draws, used to give every thread its
+		// own stream from the same seed
+		void jump() {
+			static constexpr uint64_t JUMP[] = {0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C, 0xA9582618E03FC9AA, 0x39ABDC4529B1661C};
+
+			uint64_t jumped[4] = {};
+			for (uint64_t mask : JUMP) {
+				for (int bit = 0; bit < 64; ++bit) {
+					if (mask & (UINT64_C(1) << bit)) {
+						for (int i = 0; i < 4; ++i) {
+							jumped[i] ^= state[i];
+						}
+					}
+					(*this)();
+				}
+			}
+
+			for (int i = 0; i < 4; ++i) {
+				state[i] = jumped[i];
+			}
+			hasSpare = false;
+		}
+
+		uint32_t next32() {
+			if (hasSpare) {
+				hasSpare = false;
+				return spare;
+			}
+
+			const uint64_t value = (*this)();
+			spare = static_cast<uint32_t>(value);
+			hasSpare = true;
+			return static_cast<uint32_t>(value >> 32);
+		}
+
+		// uniform in [0, range), Lemire's multiply and reject method
+		uint32_t bounded(uint32_t range) {
+			uint64_t product = static_cast<uint64_t>(next32()) * range;
+			uint32_t low = static_cast<uint32_t>(product);
+			if (low < range) {
+				const uint32_t threshold = (std::numeric_limits<uint32_t>::max() - range + 1) % range;
+				while (low < threshold) {
+					product = static_cast<uint64_t>(next32()) * range;
+					low = static_cast<uint32_t>(product);
+				}
+			}
+			return static_cast<uint32_t>(product >> 32);
+		}
+
+		// uniform in [0, 1)
+		double canonical() {
+			return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+		}
+
+	private:
+		static uint64_t rotl(uint64_t x, int k) {
+			return (x << k) | (x >> (64 - k));
+		}
+
+		uint64_t state[4];
+		uint32_t spare = 0;
+		bool hasSpare = false;
+};
+
+#endif
@@ -37,11 +37,13 @@
 #include "events.h"
 #include "scheduler.h"
 #include "databasetasks.h"
+#include "watchdog.h"
 
 
 extern Scheduler g_scheduler;
 extern DatabaseTasks g_databaseTasks;
 extern Dispatcher g_dispatcher;
+extern Watchdog g_watchdog;
 
 extern ConfigManager g_config;
 extern Actions* g_actions;
@@ -115,6 +117,8 @@ void Signals::dispatchSignalHandler(int signal)
 			g_scheduler.join();
 			g_databaseTasks.join();
 			g_dispatcher.join();
+			g_watchdog.shutdown();
+			g_watchdog.join();
 			break;
 #endif
 		default:
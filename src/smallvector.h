@@ -0,0 +1,236 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_SMALLVECTOR_H_E4B6F9F23D31414FA27B2485C2EF8A5B
+#define FS_SMALLVECTOR_H_E4B6F9F23D31414FA27B2485C2EF8A5B
+
+#include <new>
+#include <type_traits>
+
+// Vector that keeps up to N elements inline and only goes to the heap
+// once it grows beyond that. Iterators are invalidated by any insertion
+// or removal, as with std::vector.
+template <typename T, size_t N>
+class SmallVector
+{
+	public:
+		using value_type = T;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		SmallVector() = default;
+		SmallVector(const SmallVector& other) {
+			reserve(other.length);
+			for (const T& value : other) {
+				emplace_back(value);
+			}
+		}
+		SmallVector(SmallVector&& other) {
+			moveFrom(other);
+		}
+		~SmallVector() {
+			clear();
+			releaseHeap();
+		}
+
+		SmallVector& operator=(const SmallVector& other) {
+			if (this != &other) {
+				clear();
+				reserve(other.length);
+				for (const T& value : other) {
+					emplace_back(value);
+				}
+			}
+			return *this;
+		}
+		SmallVector& operator=(SmallVector&& other) {
+			if (this != &other) {
+				clear();
+				releaseHeap();
+				moveFrom(other);
+			}
+			return *this;
+		}
+
+		iterator begin() {
+			return elements;
+		}
+		const_iterator begin() const {
+			return elements;
+		}
+		iterator end() {
+			return elements + length;
+		}
+		const_iterator end() const {
+			return elements + length;
+		}
+
+		size_t size() const {
+			return length;
+		}
+		size_t capacity() const {
+			return reserved;
+		}
+		bool empty() const {
+			return length == 0;
+		}
+
+		T& operator[](size_t index) {
+			return elements[index];
+		}
+		const T& operator[](size_t index) const {
+			return elements[index];
+		}
+		T& front() {
+			return elements[0];
+		}
+		const T& front() const {
+			return elements[0];
+		}
+		T& back() {
+			return elements[length - 1];
+		}
+		const T& back() const {
+			return elements[length - 1];
+		}
+
+		void reserve(size_t size) {
+			if (size > reserved) {
+				grow(size);
+			}
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args) {
+			if (length == reserved) {
+				// the arguments may refer to an element of this vector
+				T value(std::forward<Args>(args)...);
+				grow(reserved * 2);
+				new (elements + length) T(std::move(value));
+			} else {
+				new (elements + length) T(std::forward<Args>(args)...);
+			}
+			return elements[length++];
+		}
+		void push_back(const T& value) {
+			emplace_back(value);
+		}
+		void push_back(T&& value) {
+			emplace_back(std::move(value));
+		}
+
+		template<typename... Args>
+		iterator emplace(const_iterator pos, Args&&... args) {
+			const size_t index = pos - elements;
+			T value(std::forward<Args>(args)...);
+			if (length == reserved) {
+				grow(reserved * 2);
+			}
+
+			if (index == length) {
+				new (elements + length) T(std::move(value));
+			} else {
+				new (elements + length) T(std::move(elements[length - 1]));
+				for (size_t i = length - 1; i > index; --i) {
+					elements[i] = std::move(elements[i - 1]);
+				}
+				elements[index] = std::move(value);
+			}
+			++length;
+			return elements + index;
+		}
+		iterator insert(const_iterator pos, const T& value) {
+			return emplace(pos, value);
+		}
+		iterator insert(const_iterator pos, T&& value) {
+			return emplace(pos, std::move(value));
+		}
+
+		iterator erase(const_iterator pos) {
+			const size_t index = pos - elements;
+			for (size_t i = index + 1; i < length; ++i) {
+				elements[i - 1] = std::move(elements[i]);
+			}
+			elements[--length].~T();
+			return elements + index;
+		}
+		void pop_back() {
+			elements[--length].~T();
+		}
+		void clear() {
+			for (size_t i = 0; i < length; ++i) {
+				elements[i].~T();
+			}
+			length = 0;
+		}
+
+	private:
+		T* getInline() {
+			return reinterpret_cast<T*>(&storage);
+		}
+		bool isInline() const {
+			return elements == reinterpret_cast<const T*>(&storage);
+		}
+
+		void grow(size_t size) {
+			T* newElements = static_cast<T*>(::operator new(size * sizeof(T)));
+			for (size_t i = 0; i < length; ++i) {
+				new (newElements + i) T(std::move(elements[i]));
+				elements[i].~T();
+			}
+
+			releaseHeap();
+			elements = newElements;
+			reserved = size;
+		}
+
+		void releaseHeap() {
+			if (!isInline()) {
+				::operator delete(elements);
+				elements = getInline();
+				reserved = N;
+			}
+		}
+
+		void moveFrom(SmallVector& other) {
+			if (other.isInline()) {
+				for (T& value : other) {
+					emplace_back(std::move(value));
+				}
+				other.clear();
+			} else {
+				elements = other.elements;
+				length = other.length;
+				reserved = other.reserved;
+
+				other.elements = other.getInline();
+				other.length = 0;
+				other.reserved = N;
+			}
+		}
+
+		typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type storage;
+		T* elements = getInline();
+		size_t length = 0;
+		size_t reserved = N;
+
+		static_assert(N > 0, "SmallVector needs room for at least one inline element");
+};
+
+#endif
@@ -32,6 +32,7 @@ extern Monsters g_monsters;
 extern Game g_game;
 
 static constexpr int32_t MINSPAWN_INTERVAL = 1000;
+static constexpr int64_t SPAWN_STATS_WINDOW = 60000;
 
 bool Spawns::loadFromXml(const std::string& filename)
 {
@@ -142,9 +143,14 @@ void Spawns::startup()
 
 void Spawns::clear()
 {
-	for (Spawn& spawn : spawnList) {
-		spawn.stopEvent();
+	if (checkEvent != 0) {
+		g_scheduler.stopEvent(checkEvent);
+		checkEvent = 0;
 	}
+	respawns.clear();
+	blockedRespawns.clear();
+	blockedCount = 0;
+
 	spawnList.clear();
 
 	loaded = false;
@@ -162,13 +168,209 @@ bool Spawns::isInZone(const Position& centerPos, int32_t radius, const Position&
 	        (pos.getY() >= centerPos.getY() - radius) && (pos.getY() <= centerPos.getY() + radius));
 }
 
-void Spawn::startSpawnCheck()
+void Spawns::scheduleRespawn(Spawn* spawn, uint32_t spawnId, const Position& pos, int64_t time)
+{
+	respawns.emplace_back(time, spawn, spawnId, pos);
+	std::push_heap(respawns.begin(), respawns.end(), std::greater<Respawn>());
+	scheduleCheck();
+}
+
+bool Spawns::isInView(const Position& playerPos, const Position& pos)
+{
+	// the same floor and range Spawn::findPlayer asks the map for
+	return playerPos.z == pos.z && Position::getDistanceX(playerPos, pos) <= Map::maxViewportX && Position::getDistanceY(playerPos, pos) <= Map::maxViewportY;
+}
+
+void Spawns::retryBlockedRespawns(const Position& oldPos, const Position* newPos /*= nullptr*/)
 {
-	if (checkSpawnEvent == 0) {
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), std::bind(&Spawn::checkSpawn, this)));
+	if (blockedRespawns.empty()) {
+		return;
+	}
+
+	// only the regions overlapping the view from oldPos can hold a respawn the player was blocking
+	const uint32_t startRegionX = std::max<int32_t>(oldPos.x - Map::maxViewportX, 0) >> Map::regionSizeBits;
+	const uint32_t startRegionY = std::max<int32_t>(oldPos.y - Map::maxViewportY, 0) >> Map::regionSizeBits;
+	const uint32_t endRegionX = (oldPos.x + Map::maxViewportX) >> Map::regionSizeBits;
+	const uint32_t endRegionY = (oldPos.y + Map::maxViewportY) >> Map::regionSizeBits;
+
+	const int64_t timeNow = OTSYS_TIME();
+	bool retried = false;
+	for (uint32_t x = startRegionX; x <= endRegionX; ++x) {
+		for (uint32_t y = startRegionY; y <= endRegionY; ++y) {
+			auto it = blockedRespawns.find(Map::getRegionKey(x, y));
+			if (it == blockedRespawns.end()) {
+				continue;
+			}
+
+			// a respawn the player still sees would only be blocked again
+			std::vector<Respawn>& parked = it->second;
+			for (size_t i = 0; i < parked.size();) {
+				const Respawn& respawn = parked[i];
+				if (!isInView(oldPos, respawn.pos) || (newPos && isInView(*newPos, respawn.pos))) {
+					++i;
+					continue;
+				}
+
+				respawns.push_back(respawn);
+				respawns.back().time = timeNow;
+				std::push_heap(respawns.begin(), respawns.end(), std::greater<Respawn>());
+
+				parked[i] = parked.back();
+				parked.pop_back();
+				--blockedCount;
+				retried = true;
+			}
+
+			if (parked.empty()) {
+				blockedRespawns.erase(it);
+			}
+		}
+	}
+
+	if (retried) {
+		scheduleCheck();
 	}
 }
 
+void Spawns::scheduleCheck()
+{
+	if (respawns.empty()) {
+		return;
+	}
+
+	const int64_t time = respawns.front().time;
+	if (checkEvent != 0) {
+		if (checkTime <= time) {
+			return;
+		}
+		g_scheduler.stopEvent(checkEvent);
+	}
+
+	checkTime = time;
+	checkEvent = g_scheduler.addEvent(createSchedulerTask(std::max<int64_t>(SCHEDULER_MINTICKS, time - OTSYS_TIME()), std::bind(&Spawns::checkRespawns, this)));
+}
+
+void Spawns::checkRespawns()
+{
+	checkEvent = 0;
+
+	const int64_t timeNow = OTSYS_TIME();
+	if (windowStart == 0) {
+		windowStart = timeNow;
+	} else if (timeNow - windowStart >= SPAWN_STATS_WINDOW) {
+		queriesPerSecond = windowQueries * 1000. / std::max<int64_t>(timeNow - windowStart, 1);
+		windowQueries = 0;
+		windowStart = timeNow;
+	}
+
+	const uint32_t maxSpawns = std::max<int32_t>(g_config.getNumber(ConfigManager::RATE_SPAWN), 1);
+	std::unordered_map<Spawn*, uint32_t> spawnCounts;
+	std::vector<Respawn> delayed;
+
+	while (!respawns.empty() && respawns.front().time <= timeNow) {
+		std::pop_heap(respawns.begin(), respawns.end(), std::greater<Respawn>());
+		Respawn respawn = respawns.back();
+		respawns.pop_back();
+
+		const uint32_t regionKey = Map::getRegionKey(respawn.pos.x >> Map::regionSizeBits, respawn.pos.y >> Map::regionSizeBits);
+		if (respawn.timeout) {
+			// only still relevant while the respawn is parked
+			if (!unparkRespawn(regionKey, respawn)) {
+				continue;
+			}
+			respawn.timeout = false;
+		}
+
+		// rateSpawn still caps the monsters a spawn brings back at once
+		uint32_t& spawnCount = spawnCounts[respawn.spawn];
+		if (spawnCount >= maxSpawns) {
+			respawn.time = timeNow + respawn.spawn->getInterval();
+			delayed.push_back(respawn);
+			continue;
+		}
+
+		const RespawnResult_t result = respawn.spawn->respawn(respawn.spawnId);
+		if (result != RESPAWN_NONE) {
+			++queries;
+			++windowQueries;
+		}
+
+		switch (result) {
+			case RESPAWN_DONE:
+				++spawns;
+				++spawnCount;
+				break;
+
+			case RESPAWN_BLOCKED: {
+				// retried when the players watching move out of view, a player
+				// idling in view still gets asked again after one interval
+				std::vector<Respawn>& parked = blockedRespawns[regionKey];
+				auto it = std::find_if(parked.begin(), parked.end(), [&respawn](const Respawn& other) {
+					return other.spawn == respawn.spawn && other.spawnId == respawn.spawnId;
+				});
+				if (it == parked.end()) {
+					parked.push_back(respawn);
+					++blockedCount;
+
+					respawn.time = timeNow + respawn.spawn->getInterval();
+					respawn.timeout = true;
+					delayed.push_back(respawn);
+				}
+				break;
+			}
+
+			case RESPAWN_NONE:
+				break;
+
+			case RESPAWN_FAILED:
+				respawn.time = timeNow + respawn.spawn->getInterval();
+				delayed.push_back(respawn);
+				break;
+		}
+	}
+
+	for (const Respawn& respawn : delayed) {
+		respawns.push_back(respawn);
+		std::push_heap(respawns.begin(), respawns.end(), std::greater<Respawn>());
+	}
+	scheduleCheck();
+}
+
+bool Spawns::unparkRespawn(uint32_t regionKey, const Respawn& respawn)
+{
+	auto it = blockedRespawns.find(regionKey);
+	if (it == blockedRespawns.end()) {
+		return false;
+	}
+
+	std::vector<Respawn>& parked = it->second;
+	auto parkedIt = std::find_if(parked.begin(), parked.end(), [&respawn](const Respawn& other) {
+		return other.spawn == respawn.spawn && other.spawnId == respawn.spawnId;
+	});
+	if (parkedIt == parked.end()) {
+		return false;
+	}
+
+	*parkedIt = parked.back();
+	parked.pop_back();
+	if (parked.empty()) {
+		blockedRespawns.erase(it);
+	}
+	--blockedCount;
+	return true;
+}
+
+SpawnStats Spawns::getStats() const
+{
+	SpawnStats stats;
+	stats.queries = queries;
+	stats.spawns = spawns;
+	stats.queriesPerSecond = queriesPerSecond;
+	stats.pending = respawns.size();
+	stats.blocked = blockedCount;
+	return stats;
+}
+
 Spawn::~Spawn()
 {
 	for (const auto& it : spawnedMap) {
@@ -180,6 +382,10 @@ Spawn::~Spawn()
 
 bool Spawn::findPlayer(const Position& pos)
 {
+	if (!g_game.map.isRegionActive(pos)) {
+		return false;
+	}
+
 	SpectatorVec spectators;
 	g_game.map.getSpectators(spectators, pos, false, true);
 	for (Creature* spectator : spectators) {
@@ -225,41 +431,35 @@ void Spawn::startup()
 	for (const auto& it : spawnMap) {
 		uint32_t spawnId = it.first;
 		const spawnBlock_t& sb = it.second;
-		spawnMonster(spawnId, sb.mType, sb.pos, sb.direction, true);
+		if (!spawnMonster(spawnId, sb.mType, sb.pos, sb.direction, true)) {
+			scheduleRespawn(spawnId);
+		}
 	}
 }
 
-void Spawn::checkSpawn()
+RespawnResult_t Spawn::respawn(uint32_t spawnId)
 {
-	checkSpawnEvent = 0;
-
-	cleanup();
-
-	uint32_t spawnCount = 0;
-
-	for (auto& it : spawnMap) {
-		uint32_t spawnId = it.first;
-		if (spawnedMap.find(spawnId) != spawnedMap.end()) {
-			continue;
-		}
-
-		spawnBlock_t& sb = it.second;
-		if (OTSYS_TIME() >= sb.lastSpawn + sb.interval) {
-			if (findPlayer(sb.pos)) {
-				sb.lastSpawn = OTSYS_TIME();
-				continue;
-			}
+	auto it = spawnMap.find(spawnId);
+	if (it == spawnMap.end() || spawnedMap.find(spawnId) != spawnedMap.end()) {
+		return RESPAWN_NONE;
+	}
 
-			spawnMonster(spawnId, sb.mType, sb.pos, sb.direction);
-			if (++spawnCount >= static_cast<uint32_t>(g_config.getNumber(ConfigManager::RATE_SPAWN))) {
-				break;
-			}
-		}
+	const spawnBlock_t& sb = it->second;
+	if (findPlayer(sb.pos)) {
+		return RESPAWN_BLOCKED;
 	}
 
-	if (spawnedMap.size() < spawnMap.size()) {
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), std::bind(&Spawn::checkSpawn, this)));
+	if (!spawnMonster(spawnId, sb.mType, sb.pos, sb.direction)) {
+		return RESPAWN_FAILED;
 	}
+	return RESPAWN_DONE;
+}
+
+void Spawn::scheduleRespawn(uint32_t spawnId)
+{
+	spawnBlock_t& sb = spawnMap[spawnId];
+	sb.lastSpawn = OTSYS_TIME();
+	g_game.map.spawns.scheduleRespawn(this, spawnId, sb.pos, sb.lastSpawn + sb.interval);
 }
 
 void Spawn::cleanup()
@@ -270,12 +470,15 @@ void Spawn::cleanup()
 		Monster* monster = it->second;
 		if (monster->isRemoved()) {
 			if (spawnId != 0) {
-				spawnMap[spawnId].lastSpawn = OTSYS_TIME();
+				scheduleRespawn(spawnId);
 			}
 
 			monster->decrementReferenceCounter();
 			it = spawnedMap.erase(it);
 		} else if (!isInSpawnZone(monster->getPosition()) && spawnId != 0) {
+			// it wandered off, its place may be taken again
+			scheduleRespawn(spawnId);
+
 			spawnedMap.insert(spawned_pair(0, monster));
 			it = spawnedMap.erase(it);
 		} else {
@@ -310,17 +513,16 @@ void Spawn::removeMonster(Monster* monster)
 {
 	for (auto it = spawnedMap.begin(), end = spawnedMap.end(); it != end; ++it) {
 		if (it->second == monster) {
+			uint32_t spawnId = it->first;
 			monster->decrementReferenceCounter();
 			spawnedMap.erase(it);
+
+			if (spawnId != 0) {
+				scheduleRespawn(spawnId);
+			}
 			break;
 		}
 	}
-}
 
-void Spawn::stopEvent()
-{
-	if (checkSpawnEvent != 0) {
-		g_scheduler.stopEvent(checkSpawnEvent);
-		checkSpawnEvent = 0;
-	}
+	cleanup();
 }
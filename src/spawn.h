@@ -35,6 +35,13 @@ struct spawnBlock_t {
 	Direction direction;
 };
 
+enum RespawnResult_t {
+	RESPAWN_DONE,
+	RESPAWN_NONE, // the monster is already back
+	RESPAWN_BLOCKED, // a player is watching
+	RESPAWN_FAILED,
+};
+
 class Spawn
 {
 	public:
@@ -53,8 +60,7 @@ class Spawn
 		}
 		void startup();
 
-		void startSpawnCheck();
-		void stopEvent();
+		RespawnResult_t respawn(uint32_t spawnId);
 
 		bool isInSpawnZone(const Position& pos);
 		void cleanup();
@@ -72,11 +78,18 @@ class Spawn
 		int32_t radius;
 
 		uint32_t interval = 60000;
-		uint32_t checkSpawnEvent = 0;
 
 		static bool findPlayer(const Position& pos);
 		bool spawnMonster(uint32_t spawnId, MonsterType* mType, const Position& pos, Direction dir, bool startup = false);
-		void checkSpawn();
+		void scheduleRespawn(uint32_t spawnId);
+};
+
+struct SpawnStats {
+	uint64_t queries = 0;
+	uint64_t spawns = 0;
+	double queriesPerSecond = 0;
+	size_t pending = 0;
+	size_t blocked = 0;
 };
 
 class Spawns
@@ -92,7 +105,49 @@ class Spawns
 			return started;
 		}
 
+		void scheduleRespawn(Spawn* spawn, uint32_t spawnId, const Position& pos, int64_t time);
+		// retries the respawns a player saw from oldPos and no longer sees
+		// from newPos, or all it saw when the player left the map
+		void retryBlockedRespawns(const Position& oldPos, const Position* newPos = nullptr);
+
+		SpawnStats getStats() const;
+
 	private:
+		struct Respawn {
+			Respawn(int64_t time, Spawn* spawn, uint32_t spawnId, const Position& pos) : time(time), spawn(spawn), spawnId(spawnId), pos(pos) {}
+
+			bool operator>(const Respawn& other) const {
+				return time > other.time;
+			}
+
+			int64_t time;
+			Spawn* spawn;
+			uint32_t spawnId;
+			Position pos;
+			bool timeout = false; // fallback retry of a blocked respawn
+		};
+
+		static bool isInView(const Position& playerPos, const Position& pos);
+
+		void checkRespawns();
+		void scheduleCheck();
+		bool unparkRespawn(uint32_t regionKey, const Respawn& respawn);
+
+		// min-heap on time
+		std::vector<Respawn> respawns;
+		// blocked respawns by map region of their position
+		std::unordered_map<uint32_t, std::vector<Respawn>> blockedRespawns;
+		size_t blockedCount = 0;
+
+		uint64_t queries = 0;
+		uint64_t spawns = 0;
+		uint64_t windowQueries = 0;
+		int64_t windowStart = 0;
+		double queriesPerSecond = 0;
+
+		int64_t checkTime = 0;
+		uint32_t checkEvent = 0;
+
 		std::forward_list<Npc*> npcList;
 		std::forward_list<Spawn> spawnList;
 		std::string filename;
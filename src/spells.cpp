@@ -107,6 +107,8 @@ void Spells::clearMaps(bool fromLua)
 		}
 	}
 
+	buildInstantTree();
+
 	for (auto rune = runes.begin(); rune != runes.end(); ) {
 		if (fromLua == rune->second.fromLua) {
 			rune = runes.erase(rune);
@@ -116,6 +118,14 @@ void Spells::clearMaps(bool fromLua)
 	}
 }
 
+void Spells::buildInstantTree()
+{
+	instantTree.clear();
+	for (auto& it : instants) {
+		instantTree.insert(it.first, &it.second);
+	}
+}
+
 void Spells::clear(bool fromLua)
 {
 	clearMaps(fromLua);
@@ -148,7 +158,9 @@ bool Spells::registerEvent(Event_ptr event, const pugi::xml_node&)
 	InstantSpell* instant = dynamic_cast<InstantSpell*>(event.get());
 	if (instant) {
 		auto result = instants.emplace(instant->getWords(), std::move(*instant));
-		if (!result.second) {
+		if (result.second) {
+			instantTree.insert(result.first->first, &result.first->second);
+		} else {
 			std::cout << "[Warning - Spells::registerEvent] Duplicate registered instant spell with words: " << instant->getWords() << std::endl;
 		}
 		return result.second;
@@ -172,7 +184,9 @@ bool Spells::registerInstantLuaEvent(InstantSpell* event)
 	if (instant) {
 		std::string words = instant->getWords();
 		auto result = instants.emplace(instant->getWords(), std::move(*instant));
-		if (!result.second) {
+		if (result.second) {
+			instantTree.insert(result.first->first, &result.first->second);
+		} else {
 			std::cout << "[Warning - Spells::registerInstantLuaEvent] Duplicate registered instant spell with words: " << words << std::endl;
 		}
 		return result.second;
@@ -231,20 +245,7 @@ RuneSpell* Spells::getRuneSpellByName(const std::string& name)
 
 InstantSpell* Spells::getInstantSpell(const std::string& words)
 {
-	InstantSpell* result = nullptr;
-
-	for (auto& it : instants) {
-		const std::string& instantSpellWords = it.second.getWords();
-		size_t spellLen = instantSpellWords.length();
-		if (strncasecmp(instantSpellWords.c_str(), words.c_str(), spellLen) == 0) {
-			if (!result || spellLen > result->getWords().length()) {
-				result = &it.second;
-				if (words.length() == spellLen) {
-					break;
-				}
-			}
-		}
-	}
+	InstantSpell* result = instantTree.findLongestPrefix(words);
 
 	if (result) {
 		const std::string& resultWords = result->getWords();
@@ -710,10 +711,10 @@ bool Spell::playerInstantSpellCheck(Player* player, const Position& toPos)
 		return false;
 	}
 
+	PlaceholderTile placeholder;
 	Tile* tile = g_game.map.getTile(toPos);
 	if (!tile) {
-		tile = new StaticTile(toPos.x, toPos.y, toPos.z);
-		g_game.map.setTile(toPos, tile);
+		tile = placeholder.create(g_game.map, toPos);
 	}
 
 	ReturnValue ret = Combat::canDoCombat(player, tile, aggressive);
@@ -812,18 +813,15 @@ void Spell::postCastSpell(Player* player, bool finishedCast /*= true*/, bool pay
 	if (finishedCast) {
 		if (!player->hasFlag(PlayerFlag_HasNoExhaustion)) {
 			if (cooldown > 0) {
-				Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLCOOLDOWN, cooldown, 0, false, spellId);
-				player->addCondition(condition);
+				player->addCooldown(CONDITION_SPELLCOOLDOWN, spellId, cooldown);
 			}
 
 			if (groupCooldown > 0) {
-				Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, groupCooldown, 0, false, group);
-				player->addCondition(condition);
+				player->addCooldown(CONDITION_SPELLGROUPCOOLDOWN, group, groupCooldown);
 			}
 
 			if (secondaryGroupCooldown > 0) {
-				Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, secondaryGroupCooldown, 0, false, secondaryGroup);
-				player->addCondition(condition);
+				player->addCooldown(CONDITION_SPELLGROUPCOOLDOWN, secondaryGroup, secondaryGroupCooldown);
 			}
 		}
 
@@ -950,18 +948,15 @@ bool InstantSpell::playerCastInstant(Player* player, std::string& param)
 			if (!target || target->getHealth() <= 0) {
 				if (!casterTargetOrDirection) {
 					if (cooldown > 0) {
-						Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLCOOLDOWN, cooldown, 0, false, spellId);
-						player->addCondition(condition);
+						player->addCooldown(CONDITION_SPELLCOOLDOWN, spellId, cooldown);
 					}
 
 					if (groupCooldown > 0) {
-						Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, groupCooldown, 0, false, group);
-						player->addCondition(condition);
+						player->addCooldown(CONDITION_SPELLGROUPCOOLDOWN, group, groupCooldown);
 					}
 
 					if (secondaryGroupCooldown > 0) {
-						Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, secondaryGroupCooldown, 0, false, secondaryGroup);
-						player->addCondition(condition);
+						player->addCooldown(CONDITION_SPELLGROUPCOOLDOWN, secondaryGroup, secondaryGroupCooldown);
 					}
 
 					player->sendCancelMessage(ret);
@@ -1014,18 +1009,15 @@ bool InstantSpell::playerCastInstant(Player* player, std::string& param)
 
 			if (ret != RETURNVALUE_NOERROR) {
 				if (cooldown > 0) {
-					Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLCOOLDOWN, cooldown, 0, false, spellId);
-					player->addCondition(condition);
+					player->addCooldown(CONDITION_SPELLCOOLDOWN, spellId, cooldown);
 				}
 
 				if (groupCooldown > 0) {
-					Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, groupCooldown, 0, false, group);
-					player->addCondition(condition);
+					player->addCooldown(CONDITION_SPELLGROUPCOOLDOWN, group, groupCooldown);
 				}
 
 				if (secondaryGroupCooldown > 0) {
-					Condition* condition = Condition::createCondition(CONDITIONID_DEFAULT, CONDITION_SPELLGROUPCOOLDOWN, secondaryGroupCooldown, 0, false, secondaryGroup);
-					player->addCondition(condition);
+					player->addCooldown(CONDITION_SPELLGROUPCOOLDOWN, secondaryGroup, secondaryGroupCooldown);
 				}
 
 				player->sendCancelMessage(ret);
@@ -72,8 +72,11 @@ class Spells final : public BaseEvents
 		Event_ptr getEvent(const std::string& nodeName) override;
 		bool registerEvent(Event_ptr event, const pugi::xml_node& node) override;
 
+		void buildInstantTree();
+
 		std::map<uint16_t, RuneSpell> runes;
 		std::map<std::string, InstantSpell> instants;
+		PrefixTree<InstantSpell> instantTree;
 
 		friend class CombatSpell;
 		LuaScriptInterface scriptInterface { "Spell Interface" };
@@ -0,0 +1,138 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_STORAGEMAP_H_EE164E5CF4AB4DCFBC19B39E48AEE7D9
+#define FS_STORAGEMAP_H_EE164E5CF4AB4DCFBC19B39E48AEE7D9
+
+// Player storage values kept sorted by key in one contiguous array. Every
+// entry remembers whether it changed since the last save and erased keys
+// are collected, so a save only writes what actually changed.
+class StorageMap
+{
+	public:
+		struct Entry {
+			Entry(uint32_t key, int32_t value, bool dirty) : key(key), value(value), dirty(dirty) {}
+
+			uint32_t key;
+			int32_t value;
+			bool dirty;
+		};
+
+		using const_iterator = std::vector<Entry>::const_iterator;
+
+		const int32_t* find(uint32_t key) const {
+			auto it = lowerBound(key);
+			if (it == entries.end() || it->key != key) {
+				return nullptr;
+			}
+			return &it->value;
+		}
+
+		// adds a value read from the database, it is not written back
+		// until it changes; loading in key order only appends
+		void load(uint32_t key, int32_t value) {
+			if (entries.empty() || entries.back().key < key) {
+				entries.emplace_back(key, value, false);
+			} else {
+				set(key, value);
+				lowerBound(key)->dirty = false;
+			}
+		}
+
+		void set(uint32_t key, int32_t value) {
+			auto it = lowerBound(key);
+			if (it != entries.end() && it->key == key) {
+				if (it->value != value) {
+					it->value = value;
+					it->dirty = true;
+				}
+				return;
+			}
+
+			entries.emplace(it, key, value, true);
+
+			// the upsert of the new value replaces the pending delete
+			auto removed = std::find(removedKeys.begin(), removedKeys.end(), key);
+			if (removed != removedKeys.end()) {
+				*removed = removedKeys.back();
+				removedKeys.pop_back();
+			}
+		}
+
+		bool erase(uint32_t key) {
+			auto it = lowerBound(key);
+			if (it == entries.end() || it->key != key) {
+				return false;
+			}
+
+			entries.erase(it);
+			removedKeys.push_back(key);
+			return true;
+		}
+
+		// erases every key in [first, last]
+		void eraseRange(uint32_t first, uint32_t last) {
+			auto begin = lowerBound(first);
+			auto end = begin;
+			while (end != entries.end() && end->key <= last) {
+				removedKeys.push_back(end->key);
+				++end;
+			}
+			entries.erase(begin, end);
+		}
+
+		const_iterator begin() const {
+			return entries.begin();
+		}
+		const_iterator end() const {
+			return entries.end();
+		}
+		size_t size() const {
+			return entries.size();
+		}
+
+		const std::vector<uint32_t>& getRemovedKeys() const {
+			return removedKeys;
+		}
+
+		// called once the changes are in the database
+		void clearDirty() {
+			for (Entry& entry : entries) {
+				entry.dirty = false;
+			}
+			removedKeys.clear();
+		}
+
+	private:
+		std::vector<Entry>::iterator lowerBound(uint32_t key) {
+			return std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& entry, uint32_t other) {
+				return entry.key < other;
+			});
+		}
+		std::vector<Entry>::const_iterator lowerBound(uint32_t key) const {
+			return std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& entry, uint32_t other) {
+				return entry.key < other;
+			});
+		}
+
+		std::vector<Entry> entries;
+		std::vector<uint32_t> removedKeys;
+};
+
+#endif
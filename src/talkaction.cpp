@@ -44,9 +44,19 @@ void TalkActions::clear(bool fromLua)
 		}
 	}
 
+	buildTalkActionTree();
+
 	reInitState(fromLua);
 }
 
+void TalkActions::buildTalkActionTree()
+{
+	talkActionTree.clear();
+	for (const auto& it : talkActions) {
+		talkActionTree.insert(it.first, &it.second);
+	}
+}
+
 LuaScriptInterface& TalkActions::getScriptInterface()
 {
 	return scriptInterface;
@@ -68,43 +78,47 @@ Event_ptr TalkActions::getEvent(const std::string& nodeName)
 bool TalkActions::registerEvent(Event_ptr event, const pugi::xml_node&)
 {
 	TalkAction_ptr talkAction{static_cast<TalkAction*>(event.release())}; // event is guaranteed to be a TalkAction
-	talkActions.emplace(talkAction->getWords(), std::move(*talkAction));
+	auto result = talkActions.emplace(talkAction->getWords(), std::move(*talkAction));
+	if (result.second) {
+		talkActionTree.insert(result.first->first, &result.first->second);
+	}
 	return true;
 }
 
 bool TalkActions::registerLuaEvent(TalkAction* event)
 {
 	TalkAction_ptr talkAction{ event };
-	talkActions.emplace(talkAction->getWords(), std::move(*talkAction));
+	auto result = talkActions.emplace(talkAction->getWords(), std::move(*talkAction));
+	if (result.second) {
+		talkActionTree.insert(result.first->first, &result.first->second);
+	}
 	return true;
 }
 
 TalkActionResult_t TalkActions::playerSaySpell(Player* player, SpeakClasses type, const std::string& words) const
 {
-	size_t wordsLength = words.length();
-	for (auto it = talkActions.begin(); it != talkActions.end(); ) {
-		const std::string& talkactionWords = it->first;
-		size_t talkactionLength = talkactionWords.length();
-		if (wordsLength < talkactionLength || strncasecmp(words.c_str(), talkactionWords.c_str(), talkactionLength) != 0) {
-			++it;
-			continue;
+	// the tree visits matches shortest first, but the first match in the
+	// (case sensitive) registration map order has always won, so keep that
+	const TalkAction* match = nullptr;
+	std::string matchParam;
+	talkActionTree.forEachPrefix(words, [&](size_t talkactionLength, const TalkAction* talkAction) -> bool {
+		if (match && match->getWords() < talkAction->getWords()) {
+			return false;
 		}
 
 		std::string param;
-		if (wordsLength != talkactionLength) {
+		if (words.length() != talkactionLength) {
 			param = words.substr(talkactionLength);
 			if (param.front() != ' ') {
-				++it;
-				continue;
+				return false;
 			}
 			trim_left(param, ' ');
 
-			std::string separator = it->second.getSeparator();
+			std::string separator = talkAction->getSeparator();
 			if (separator != " ") {
 				if (!param.empty()) {
 					if (param != separator) {
-						++it;
-						continue;
+						return false;
 					} else {
 						param.erase(param.begin());
 					}
@@ -112,11 +126,17 @@ TalkActionResult_t TalkActions::playerSaySpell(Player* player, SpeakClasses type
 			}
 		}
 
-		if (it->second.executeSay(player, param, type)) {
-			return TALKACTION_CONTINUE;
-		} else {
-			return TALKACTION_BREAK;
-		}
+		match = talkAction;
+		matchParam = std::move(param);
+		return false;
+	});
+
+	if (!match) {
+		return TALKACTION_CONTINUE;
+	}
+
+	if (!match->executeSay(player, matchParam, type)) {
+		return TALKACTION_BREAK;
 	}
 	return TALKACTION_CONTINUE;
 }
@@ -23,6 +23,7 @@
 #include "luascript.h"
 #include "baseevents.h"
 #include "const.h"
+#include "prefixtree.h"
 
 class TalkAction;
 using TalkAction_ptr = std::unique_ptr<TalkAction>;
@@ -85,7 +86,10 @@ class TalkActions final : public BaseEvents
 		Event_ptr getEvent(const std::string& nodeName) override;
 		bool registerEvent(Event_ptr event, const pugi::xml_node& node) override;
 
+		void buildTalkActionTree();
+
 		std::map<std::string, TalkAction> talkActions;
+		PrefixTree<const TalkAction> talkActionTree;
 
 		LuaScriptInterface scriptInterface;
 };
@@ -20,9 +20,13 @@
 #include "otpch.h"
 
 #include "tasks.h"
+#include "events.h"
 #include "game.h"
+#include "luascript.h"
 
 extern Game g_game;
+extern Events* g_events;
+extern LuaEnvironment g_luaEnvironment;
 
 Task* createTask(std::function<void (void)> f)
 {
@@ -44,8 +48,16 @@ void Dispatcher::threadMain()
 		taskLockUnique.lock();
 
 		if (taskList.empty()) {
+			// use the idle time for incremental Lua garbage collection, so
+			// less of it is left to run in the middle of a script
+			taskLockUnique.unlock();
+			bool collecting = g_luaEnvironment.collectGarbageStep();
+			taskLockUnique.lock();
+
 			//if the list is empty wait for signal
-			taskSignal.wait(taskLockUnique);
+			if (taskList.empty() && !collecting) {
+				taskSignal.wait(taskLockUnique);
+			}
 		}
 
 		if (!taskList.empty()) {
@@ -56,8 +68,19 @@ void Dispatcher::threadMain()
 
 			if (!task->hasExpired()) {
 				++dispatcherCycle;
+				taskType.store(&task->getType(), std::memory_order_relaxed);
+				taskStartTime.store(OTSYS_TIME(), std::memory_order_release);
+
 				// execute it
 				(*task)();
+
+				// deliver the batched script events the task collected
+				if (g_events && g_events->hasBatchedEvents()) {
+					g_events->flushBatchedEvents();
+				}
+
+				taskStartTime.store(0, std::memory_order_release);
+				taskType.store(nullptr, std::memory_order_relaxed);
 			}
 			delete task;
 		} else {
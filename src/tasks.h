@@ -40,6 +40,11 @@ class Task
 			func();
 		}
 
+		// the type of the wrapped callable, used to name a stalled task
+		const std::type_info& getType() const {
+			return func.target_type();
+		}
+
 		void setDontExpire() {
 			expiration = SYSTEM_TIME_ZERO;
 		}
@@ -74,6 +79,15 @@ class Dispatcher : public ThreadHolder<Dispatcher> {
 			return dispatcherCycle;
 		}
 
+		// start time (OTSYS_TIME) and type of the running task, 0 and
+		// nullptr while idle, read by the watchdog from its own thread
+		int64_t getTaskStartTime() const {
+			return taskStartTime.load(std::memory_order_acquire);
+		}
+		const std::type_info* getTaskType() const {
+			return taskType.load(std::memory_order_relaxed);
+		}
+
 		void threadMain();
 
 	private:
@@ -83,6 +97,9 @@ class Dispatcher : public ThreadHolder<Dispatcher> {
 
 		std::list<Task*> taskList;
 		uint64_t dispatcherCycle = 0;
+
+		std::atomic<int64_t> taskStartTime {0};
+		std::atomic<const std::type_info*> taskType {nullptr};
 };
 
 extern Dispatcher g_dispatcher;
@@ -21,9 +21,20 @@
 
 #include "teleport.h"
 #include "game.h"
+#include "pool.h"
 
 extern Game g_game;
 
+void* Teleport::operator new(size_t size)
+{
+	return getSlabPool<Teleport>("teleport").allocate(size);
+}
+
+void Teleport::operator delete(void* p, size_t size)
+{
+	getSlabPool<Teleport>("teleport").deallocate(p, size);
+}
+
 Attr_ReadValue Teleport::readAttr(AttrTypes_t attr, PropStream& propStream)
 {
 	if (attr == ATTR_TELE_DEST) {
@@ -27,6 +27,10 @@ class Teleport final : public Item, public Cylinder
 	public:
 		explicit Teleport(uint16_t type) : Item(type) {};
 
+		// allocated from a type-segregated slab pool
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		Teleport* getTeleport() override {
 			return this;
 		}
@@ -31,6 +31,7 @@
 #include "movement.h"
 #include "teleport.h"
 #include "trashholder.h"
+#include "pool.h"
 
 extern Game g_game;
 extern MoveEvents* g_moveEvents;
@@ -38,8 +39,41 @@ extern MoveEvents* g_moveEvents;
 StaticTile real_nullptr_tile(0xFFFF, 0xFFFF, 0xFF);
 Tile& Tile::nullptr_tile = real_nullptr_tile;
 
+void* StaticTile::operator new(size_t size)
+{
+	return getSlabPool<StaticTile>("statictile", true).allocate(size);
+}
+
+void StaticTile::operator delete(void* p, size_t size)
+{
+	getSlabPool<StaticTile>("statictile", true).deallocate(p, size);
+}
+
+void* DynamicTile::operator new(size_t size)
+{
+	return getSlabPool<DynamicTile>("dynamictile").allocate(size);
+}
+
+void DynamicTile::operator delete(void* p, size_t size)
+{
+	getSlabPool<DynamicTile>("dynamictile").deallocate(p, size);
+}
+
 bool Tile::hasProperty(ITEMPROPERTY prop) const
 {
+	// these properties are summarized in the tile flags by setTileFlags/resetTileFlags
+	switch (prop) {
+		case CONST_PROP_BLOCKSOLID: return hasFlag(TILESTATE_BLOCKSOLID);
+		case CONST_PROP_BLOCKPROJECTILE: return hasFlag(TILESTATE_BLOCKPROJECTILE);
+		case CONST_PROP_BLOCKPATH: return hasFlag(TILESTATE_BLOCKPATH);
+		case CONST_PROP_IMMOVABLEBLOCKSOLID: return hasFlag(TILESTATE_IMMOVABLEBLOCKSOLID);
+		case CONST_PROP_IMMOVABLEBLOCKPATH: return hasFlag(TILESTATE_IMMOVABLEBLOCKPATH);
+		case CONST_PROP_IMMOVABLENOFIELDBLOCKPATH: return hasFlag(TILESTATE_IMMOVABLENOFIELDBLOCKPATH);
+		case CONST_PROP_NOFIELDBLOCKPATH: return hasFlag(TILESTATE_NOFIELDBLOCKPATH);
+		case CONST_PROP_SUPPORTHANGABLE: return hasFlag(TILESTATE_SUPPORTS_HANGABLE);
+		default: break;
+	}
+
 	if (ground && ground->hasProperty(prop)) {
 		return true;
 	}
@@ -73,6 +107,23 @@ bool Tile::hasProperty(const Item* exclude, ITEMPROPERTY prop) const
 	return false;
 }
 
+bool Tile::hasMoveEventItem(const Item* exclude) const
+{
+	if (ground && exclude != ground && g_moveEvents->hasItemEvents(ground)) {
+		return true;
+	}
+
+	if (const TileItemVector* items = getItemList()) {
+		for (const Item* item : *items) {
+			if (item != exclude && g_moveEvents->hasItemEvents(item)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 bool Tile::hasHeight(uint32_t n) const
 {
 	uint32_t height = 0;
@@ -335,7 +386,7 @@ Item* Tile::getItemByTopOrder(int32_t topOrder)
 	//4: creatures
 	if (TileItemVector* items = getItemList()) {
 		for (auto it = ItemVector::const_reverse_iterator(items->getEndTopItem()), end = ItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
-			if (Item::items[(*it)->getID()].alwaysOnTopOrder == topOrder) {
+			if (Item::items.getHotType((*it)->getID()).alwaysOnTopOrder == topOrder) {
 				return (*it);
 			}
 		}
@@ -353,15 +404,13 @@ Thing* Tile::getTopVisibleThing(const Creature* creature)
 	TileItemVector* items = getItemList();
 	if (items) {
 		for (ItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
-			const ItemType& iit = Item::items[(*it)->getID()];
-			if (!iit.lookThrough) {
+			if (!Item::items.getHotType((*it)->getID()).hasFlag(ITEMTYPE_FLAG_LOOKTHROUGH)) {
 				return (*it);
 			}
 		}
 
 		for (auto it = ItemVector::const_reverse_iterator(items->getEndTopItem()), end = ItemVector::const_reverse_iterator(items->getBeginTopItem()); it != end; ++it) {
-			const ItemType& iit = Item::items[(*it)->getID()];
-			if (!iit.lookThrough) {
+			if (!Item::items.getHotType((*it)->getID()).hasFlag(ITEMTYPE_FLAG_LOOKTHROUGH)) {
 				return (*it);
 			}
 		}
@@ -605,17 +654,13 @@ ReturnValue Tile::queryAdd(int32_t, const Thing& thing, uint32_t, uint32_t flags
 			}
 		} else {
 			//FLAG_IGNOREBLOCKITEM is set
-			if (ground) {
-				const ItemType& iiType = Item::items[ground->getID()];
-				if (iiType.blockSolid && (!iiType.moveable || ground->hasAttribute(ITEM_ATTRIBUTE_UNIQUEID))) {
-					return RETURNVALUE_NOTPOSSIBLE;
-				}
+			if (ground && ground->hasProperty(CONST_PROP_IMMOVABLEBLOCKSOLID)) {
+				return RETURNVALUE_NOTPOSSIBLE;
 			}
 
 			if (const auto items = getItemList()) {
 				for (const Item* item : *items) {
-					const ItemType& iiType = Item::items[item->getID()];
-					if (iiType.blockSolid && (!iiType.moveable || item->hasAttribute(ITEM_ATTRIBUTE_UNIQUEID))) {
+					if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKSOLID)) {
 						return RETURNVALUE_NOTPOSSIBLE;
 					}
 				}
@@ -655,14 +700,14 @@ ReturnValue Tile::queryAdd(int32_t, const Thing& thing, uint32_t, uint32_t flags
 			}
 		} else {
 			if (ground) {
-				const ItemType& iiType = Item::items[ground->getID()];
-				if (iiType.blockSolid) {
-					if (!iiType.allowPickupable || item->isMagicField() || item->isBlocking()) {
+				const ItemTypeHot& iiType = Item::items.getHotType(ground->getID());
+				if (iiType.hasFlag(ITEMTYPE_FLAG_BLOCKSOLID)) {
+					if (!iiType.hasFlag(ITEMTYPE_FLAG_ALLOWPICKUPABLE) || item->isMagicField() || item->isBlocking()) {
 						if (!item->isPickupable()) {
 							return RETURNVALUE_NOTENOUGHROOM;
 						}
 
-						if (!iiType.hasHeight || iiType.pickupable || iiType.isBed()) {
+						if (!iiType.hasFlag(ITEMTYPE_FLAG_HASHEIGHT) || iiType.hasFlag(ITEMTYPE_FLAG_PICKUPABLE | ITEMTYPE_FLAG_BED)) {
 							return RETURNVALUE_NOTENOUGHROOM;
 						}
 					}
@@ -671,12 +716,12 @@ ReturnValue Tile::queryAdd(int32_t, const Thing& thing, uint32_t, uint32_t flags
 
 			if (items) {
 				for (const Item* tileItem : *items) {
-					const ItemType& iiType = Item::items[tileItem->getID()];
-					if (!iiType.blockSolid) {
+					const ItemTypeHot& iiType = Item::items.getHotType(tileItem->getID());
+					if (!iiType.hasFlag(ITEMTYPE_FLAG_BLOCKSOLID)) {
 						continue;
 					}
 
-					if (iiType.allowPickupable && !item->isMagicField() && !item->isBlocking()) {
+					if (iiType.hasFlag(ITEMTYPE_FLAG_ALLOWPICKUPABLE) && !item->isMagicField() && !item->isBlocking()) {
 						continue;
 					}
 
@@ -684,7 +729,7 @@ ReturnValue Tile::queryAdd(int32_t, const Thing& thing, uint32_t, uint32_t flags
 						return RETURNVALUE_NOTENOUGHROOM;
 					}
 
-					if (!iiType.hasHeight || iiType.pickupable || iiType.isBed()) {
+					if (!iiType.hasFlag(ITEMTYPE_FLAG_HASHEIGHT) || iiType.hasFlag(ITEMTYPE_FLAG_PICKUPABLE | ITEMTYPE_FLAG_BED)) {
 						return RETURNVALUE_NOTENOUGHROOM;
 					}
 				}
@@ -851,7 +896,8 @@ void Tile::addThing(int32_t, Thing* thing)
 		item->setParent(this);
 
 		const ItemType& itemType = Item::items[item->getID()];
-		if (itemType.isGroundTile()) {
+		const ItemTypeHot& itemTypeHot = Item::items.getHotType(item->getID());
+		if (itemTypeHot.hasFlag(ITEMTYPE_FLAG_GROUND)) {
 			if (ground == nullptr) {
 				ground = item;
 				onAddTileItem(item);
@@ -867,12 +913,12 @@ void Tile::addThing(int32_t, Thing* thing)
 				onUpdateTileItem(oldGround, oldType, item, itemType);
 				postRemoveNotification(oldGround, nullptr, 0);
 			}
-		} else if (itemType.alwaysOnTop) {
-			if (itemType.isSplash() && items) {
+		} else if (itemTypeHot.hasFlag(ITEMTYPE_FLAG_ALWAYSONTOP)) {
+			if (itemTypeHot.hasFlag(ITEMTYPE_FLAG_SPLASH) && items) {
 				//remove old splash if exists
 				for (ItemVector::const_iterator it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
 					Item* oldSplash = *it;
-					if (!Item::items[oldSplash->getID()].isSplash()) {
+					if (!Item::items.getHotType(oldSplash->getID()).hasFlag(ITEMTYPE_FLAG_SPLASH)) {
 						continue;
 					}
 
@@ -889,7 +935,7 @@ void Tile::addThing(int32_t, Thing* thing)
 			if (items) {
 				for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
 					//Note: this is different from internalAddThing
-					if (itemType.alwaysOnTopOrder <= Item::items[(*it)->getID()].alwaysOnTopOrder) {
+					if (itemTypeHot.alwaysOnTopOrder <= Item::items.getHotType((*it)->getID()).alwaysOnTopOrder) {
 						items->insert(it, item);
 						isInserted = true;
 						break;
@@ -905,7 +951,7 @@ void Tile::addThing(int32_t, Thing* thing)
 
 			onAddTileItem(item);
 		} else {
-			if (itemType.isMagicField()) {
+			if (itemTypeHot.hasFlag(ITEMTYPE_FLAG_MAGICFIELD)) {
 				//remove old field item if exists
 				if (items) {
 					for (ItemVector::const_iterator it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
@@ -1075,7 +1121,7 @@ void Tile::removeThing(Thing* thing, uint32_t count)
 	}
 
 	const ItemType& itemType = Item::items[item->getID()];
-	if (itemType.alwaysOnTop) {
+	if (item->isAlwaysOnTop()) {
 		auto it = std::find(items->getBeginTopItem(), items->getEndTopItem(), item);
 		if (it == items->getEndTopItem()) {
 			return;
@@ -1100,7 +1146,7 @@ void Tile::removeThing(Thing* thing, uint32_t count)
 			return;
 		}
 
-		if (itemType.stackable && count != item->getItemCount()) {
+		if (item->isStackable() && count != item->getItemCount()) {
 			uint8_t newCount = static_cast<uint8_t>(std::max<int32_t>(0, static_cast<int32_t>(item->getItemCount() - count)));
 			item->setItemCount(newCount);
 			onUpdateTileItem(item, itemType, item, itemType);
@@ -1126,6 +1172,10 @@ void Tile::removeThing(Thing* thing, uint32_t count)
 void Tile::removeCreature(Creature* creature)
 {
 	g_game.map.getQTNode(tilePos.x, tilePos.y)->removeCreature(creature);
+	if (creature->getPlayer()) {
+		g_game.map.removeRegionPlayer(tilePos);
+		g_game.map.spawns.retryBlockedRespawns(tilePos);
+	}
 	removeThing(creature, 0);
 }
 
@@ -1452,8 +1502,8 @@ void Tile::internalAddThing(uint32_t, Thing* thing)
 			return;
 		}
 
-		const ItemType& itemType = Item::items[item->getID()];
-		if (itemType.isGroundTile()) {
+		const ItemTypeHot& itemType = Item::items.getHotType(item->getID());
+		if (itemType.hasFlag(ITEMTYPE_FLAG_GROUND)) {
 			if (ground == nullptr) {
 				ground = item;
 				setTileFlags(item);
@@ -1466,10 +1516,10 @@ void Tile::internalAddThing(uint32_t, Thing* thing)
 			return /*RETURNVALUE_NOTPOSSIBLE*/;
 		}
 
-		if (itemType.alwaysOnTop) {
+		if (itemType.hasFlag(ITEMTYPE_FLAG_ALWAYSONTOP)) {
 			bool isInserted = false;
 			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-				if (Item::items[(*it)->getID()].alwaysOnTopOrder > itemType.alwaysOnTopOrder) {
+				if (Item::items.getHotType((*it)->getID()).alwaysOnTopOrder > itemType.alwaysOnTopOrder) {
 					items->insert(it, item);
 					isInserted = true;
 					break;
@@ -1490,8 +1540,10 @@ void Tile::internalAddThing(uint32_t, Thing* thing)
 
 void Tile::setTileFlags(const Item* item)
 {
+	const uint32_t oldFlags = flags;
+
 	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
-		const ItemType& it = Item::items[item->getID()];
+		const ItemTypeHot& it = Item::items.getHotType(item->getID());
 		if (it.floorChange != 0) {
 			setFlag(it.floorChange);
 		}
@@ -1505,6 +1557,14 @@ void Tile::setTileFlags(const Item* item)
 		setFlag(TILESTATE_BLOCKPATH);
 	}
 
+	if (item->hasProperty(CONST_PROP_IMMOVABLEBLOCKPATH)) {
+		setFlag(TILESTATE_IMMOVABLEBLOCKPATH);
+	}
+
+	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+		setFlag(TILESTATE_BLOCKPROJECTILE);
+	}
+
 	if (item->hasProperty(CONST_PROP_NOFIELDBLOCKPATH)) {
 		setFlag(TILESTATE_NOFIELDBLOCKPATH);
 	}
@@ -1537,6 +1597,10 @@ void Tile::setTileFlags(const Item* item)
 		setFlag(TILESTATE_BED);
 	}
 
+	if (g_moveEvents->hasItemEvents(item)) {
+		setFlag(TILESTATE_MOVEEVENT);
+	}
+
 	const Container* container = item->getContainer();
 	if (container && container->getDepotLocker()) {
 		setFlag(TILESTATE_DEPOT);
@@ -1545,11 +1609,17 @@ void Tile::setTileFlags(const Item* item)
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if ((oldFlags ^ flags) & TILESTATE_MAPMASK) {
+		g_game.map.updateFloorMasks(*this);
+	}
 }
 
 void Tile::resetTileFlags(const Item* item)
 {
-	const ItemType& it = Item::items[item->getID()];
+	const uint32_t oldFlags = flags;
+
+	const ItemTypeHot& it = Item::items.getHotType(item->getID());
 	if (it.floorChange != 0) {
 		resetFlag(TILESTATE_FLOORCHANGE);
 	}
@@ -1566,6 +1636,10 @@ void Tile::resetTileFlags(const Item* item)
 		resetFlag(TILESTATE_BLOCKPATH);
 	}
 
+	if (item->hasProperty(CONST_PROP_BLOCKPROJECTILE) && !hasProperty(item, CONST_PROP_BLOCKPROJECTILE)) {
+		resetFlag(TILESTATE_BLOCKPROJECTILE);
+	}
+
 	if (item->hasProperty(CONST_PROP_NOFIELDBLOCKPATH) && !hasProperty(item, CONST_PROP_NOFIELDBLOCKPATH)) {
 		resetFlag(TILESTATE_NOFIELDBLOCKPATH);
 	}
@@ -1603,9 +1677,17 @@ void Tile::resetTileFlags(const Item* item)
 		resetFlag(TILESTATE_DEPOT);
 	}
 
-	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
+	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE) && !hasProperty(item, CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if (hasFlag(TILESTATE_MOVEEVENT) && g_moveEvents->hasItemEvents(item) && !hasMoveEventItem(item)) {
+		resetFlag(TILESTATE_MOVEEVENT);
+	}
+
+	if ((oldFlags ^ flags) & TILESTATE_MAPMASK) {
+		g_game.map.updateFloorMasks(*this);
+	}
 }
 
 bool Tile::isMoveableBlocking() const
@@ -63,8 +63,14 @@ enum tileflags_t : uint32_t {
 	TILESTATE_IMMOVABLENOFIELDBLOCKPATH = 1 << 21,
 	TILESTATE_NOFIELDBLOCKPATH = 1 << 22,
 	TILESTATE_SUPPORTS_HANGABLE = 1 << 23,
+	TILESTATE_BLOCKPROJECTILE = 1 << 24,
+	TILESTATE_MOVEEVENT = 1 << 25,
+	TILESTATE_EPHEMERAL = 1 << 26, // created by an area effect, map compaction frees it once empty
 
 	TILESTATE_FLOORCHANGE = TILESTATE_FLOORCHANGE_DOWN | TILESTATE_FLOORCHANGE_NORTH | TILESTATE_FLOORCHANGE_SOUTH | TILESTATE_FLOORCHANGE_EAST | TILESTATE_FLOORCHANGE_WEST | TILESTATE_FLOORCHANGE_SOUTH_ALT | TILESTATE_FLOORCHANGE_EAST_ALT,
+
+	// flags mirrored into the per-floor bitmaps of the map
+	TILESTATE_MAPMASK = TILESTATE_BLOCKSOLID | TILESTATE_BLOCKPATH | TILESTATE_BLOCKPROJECTILE | TILESTATE_MAGICFIELD,
 };
 
 enum ZoneType_t {
@@ -204,6 +210,7 @@ class Tile : public Cylinder
 
 		bool hasProperty(ITEMPROPERTY prop) const;
 		bool hasProperty(const Item* exclude, ITEMPROPERTY prop) const;
+		bool hasMoveEventItem(const Item* exclude) const;
 
 		bool hasFlag(uint32_t flag) const {
 			return hasBitSet(flag, this->flags);
@@ -316,6 +323,10 @@ class DynamicTile : public Tile
 		DynamicTile(const DynamicTile&) = delete;
 		DynamicTile& operator=(const DynamicTile&) = delete;
 
+		// allocated from a type-segregated slab pool
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		TileItemVector* getItemList() override {
 			return &items;
 		}
@@ -358,6 +369,10 @@ class StaticTile final : public Tile
 		StaticTile(const StaticTile&) = delete;
 		StaticTile& operator=(const StaticTile&) = delete;
 
+		// allocated from a type-segregated slab pool
+		static void* operator new(size_t size);
+		static void operator delete(void* p, size_t size);
+
 		TileItemVector* getItemList() override {
 			return items.get();
 		}
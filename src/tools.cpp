@@ -19,6 +19,8 @@
 
 #include "otpch.h"
 
+#include <atomic>
+
 #include "tools.h"
 #include "configmanager.h"
 
@@ -294,27 +296,73 @@ IntegerVector vectorAtoi(const StringVector& stringVector)
 	return returnVector;
 }
 
-std::mt19937& getRandomGenerator()
+namespace {
+
+std::atomic<uint32_t> randomSeed{0};
+std::atomic<uint32_t> randomSeedGeneration{0};
+std::atomic<uint32_t> randomStreams{0};
+
+}
+
+void setRandomSeed(uint32_t seed)
 {
-	static std::random_device rd;
-	static std::mt19937 generator(rd());
+	if (seed == 0) {
+		// kept positive so it can be written back to config.lua as is
+		seed = std::max<uint32_t>(std::random_device()() & 0x7FFFFFFF, 1);
+	}
+
+	randomSeed.store(seed, std::memory_order_relaxed);
+	randomStreams.store(0, std::memory_order_relaxed);
+	randomSeedGeneration.fetch_add(1, std::memory_order_release);
+}
+
+uint32_t getRandomSeed()
+{
+	return randomSeed.load(std::memory_order_relaxed);
+}
+
+Xoshiro256& getRandomGenerator()
+{
+	thread_local Xoshiro256 generator;
+	thread_local uint32_t generation = std::numeric_limits<uint32_t>::max();
+
+	const uint32_t currentGeneration = randomSeedGeneration.load(std::memory_order_acquire);
+	if (generation != currentGeneration) {
+		generation = currentGeneration;
+
+		const uint32_t seed = randomSeed.load(std::memory_order_relaxed);
+		if (seed == 0) {
+			generator.seed((static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()());
+		} else {
+			// threads get their streams in the order they first draw
+			generator.seed(seed);
+			for (uint32_t stream = randomStreams.fetch_add(1, std::memory_order_relaxed); stream != 0; --stream) {
+				generator.jump();
+			}
+		}
+	}
 	return generator;
 }
 
 int32_t uniform_random(int32_t minNumber, int32_t maxNumber)
 {
-	static std::uniform_int_distribution<int32_t> uniformRand;
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
 		std::swap(minNumber, maxNumber);
 	}
-	return uniformRand(getRandomGenerator(), std::uniform_int_distribution<int32_t>::param_type(minNumber, maxNumber));
+
+	const uint32_t range = static_cast<uint32_t>(maxNumber) - static_cast<uint32_t>(minNumber);
+	Xoshiro256& generator = getRandomGenerator();
+	if (range == std::numeric_limits<uint32_t>::max()) {
+		return static_cast<int32_t>(generator.next32());
+	}
+	return static_cast<int32_t>(static_cast<uint32_t>(minNumber) + generator.bounded(range + 1));
 }
 
 int32_t normal_random(int32_t minNumber, int32_t maxNumber)
 {
-	static std::normal_distribution<float> normalRand(0.5f, 0.25f);
+	thread_local std::normal_distribution<float> normalRand(0.5f, 0.25f);
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
@@ -336,8 +384,7 @@ int32_t normal_random(int32_t minNumber, int32_t maxNumber)
 
 bool boolean_random(double probability/* = 0.5*/)
 {
-	static std::bernoulli_distribution booleanRand;
-	return booleanRand(getRandomGenerator(), std::bernoulli_distribution::param_type(probability));
+	return getRandomGenerator().canonical() < probability;
 }
 
 void trimString(std::string& str)
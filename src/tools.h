@@ -23,6 +23,7 @@
 #include <random>
 
 #include "position.h"
+#include "random.h"
 #include "const.h"
 #include "enums.h"
 
@@ -47,7 +48,12 @@ constexpr bool hasBitSet(uint32_t flag, uint32_t flags) {
 	return (flags & flag) != 0;
 }
 
-std::mt19937& getRandomGenerator();
+// Every thread draws from its own generator. A nonzero seed makes the
+// draws of each thread reproducible, 0 picks a new seed.
+void setRandomSeed(uint32_t seed);
+uint32_t getRandomSeed();
+
+Xoshiro256& getRandomGenerator();
 int32_t uniform_random(int32_t minNumber, int32_t maxNumber);
 int32_t normal_random(int32_t minNumber, int32_t maxNumber);
 bool boolean_random(double probability = 0.5);
@@ -0,0 +1,103 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "watchdog.h"
+#include "configmanager.h"
+#include "luascript.h"
+#include "tasks.h"
+#include "tools.h"
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+extern ConfigManager g_config;
+
+namespace {
+
+std::string getTypeName(const std::type_info& type)
+{
+#ifdef __GNUG__
+	int status;
+	char* name = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+	if (status == 0 && name) {
+		std::string result(name);
+		free(name);
+		return result;
+	}
+#endif
+	return type.name();
+}
+
+}
+
+void Watchdog::threadMain()
+{
+	std::unique_lock<std::mutex> watchdogLockUnique(watchdogLock);
+	while (getState() != THREAD_STATE_TERMINATED) {
+		watchdogSignal.wait_for(watchdogLockUnique, std::chrono::milliseconds(250));
+
+		int64_t maxTaskTime = g_config.getNumber(ConfigManager::DISPATCHER_WATCHDOG_TIME);
+		if (maxTaskTime <= 0) {
+			continue;
+		}
+
+		int64_t taskStartTime = g_dispatcher.getTaskStartTime();
+		if (taskStartTime == 0 || taskStartTime == reportedTaskStartTime) {
+			continue;
+		}
+
+		int64_t elapsed = OTSYS_TIME() - taskStartTime;
+		if (elapsed >= maxTaskTime) {
+			reportedTaskStartTime = taskStartTime;
+			reportStall(taskStartTime, elapsed);
+		}
+	}
+}
+
+void Watchdog::reportStall(int64_t taskStartTime, int64_t elapsed)
+{
+	const std::type_info* taskType = g_dispatcher.getTaskType();
+
+	std::cout << "[Warning - Watchdog::reportStall] Dispatcher task has been running for " << elapsed << " ms." << std::endl;
+	std::cout << "\tTask: " << (taskType ? getTypeName(*taskType) : "(Unknown)") << std::endl;
+
+	// a copy, the interface itself may be gone by now
+	const std::string interfaceName = LuaScriptInterface::getRunningInterfaceName();
+	if (interfaceName.empty()) {
+		std::cout << "\tNo Lua script is running." << std::endl;
+		return;
+	}
+
+	std::cout << "\tLua interface: " << interfaceName << ", script id: " << LuaScriptInterface::getRunningScriptId() << std::endl;
+
+	// the script file and line are printed by the count hook on the
+	// dispatcher thread, the task may have finished in the meantime
+	if (g_dispatcher.getTaskStartTime() == taskStartTime) {
+		LuaScriptInterface::requestStackDump();
+	}
+}
+
+void Watchdog::shutdown()
+{
+	setState(THREAD_STATE_TERMINATED);
+	watchdogSignal.notify_one();
+}
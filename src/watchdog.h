@@ -0,0 +1,47 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_WATCHDOG_H_081086EE09364064B57BFB22ED6E30E3
+#define FS_WATCHDOG_H_081086EE09364064B57BFB22ED6E30E3
+
+#include <condition_variable>
+#include "thread_holder_base.h"
+
+// Reports dispatcher tasks that run for longer than dispatcherWatchdogTime
+// together with the C++ task and the Lua script they are stuck in.
+class Watchdog : public ThreadHolder<Watchdog>
+{
+	public:
+		void shutdown();
+
+		void threadMain();
+
+	private:
+		void reportStall(int64_t taskStartTime, int64_t elapsed);
+
+		std::mutex watchdogLock;
+		std::condition_variable watchdogSignal;
+
+		// start time of the last task reported, each stall is logged once
+		int64_t reportedTaskStartTime = 0;
+};
+
+extern Watchdog g_watchdog;
+
+#endif
@@ -46,20 +46,18 @@ const Weapon* Weapons::getWeapon(const Item* item) const
 		return nullptr;
 	}
 
-	auto it = weapons.find(item->getID());
-	if (it == weapons.end()) {
+	const uint16_t itemId = item->getID();
+	if (itemId >= weapons.size()) {
 		return nullptr;
 	}
-	return it->second;
+	return weapons[itemId];
 }
 
 void Weapons::clear(bool fromLua)
 {
-	for (auto it = weapons.begin(); it != weapons.end(); ) {
-		if (fromLua == it->second->fromLua) {
-			it = weapons.erase(it);
-		} else {
-			++it;
+	for (Weapon*& weapon : weapons) {
+		if (weapon && fromLua == weapon->fromLua) {
+			weapon = nullptr;
 		}
 	}
 
@@ -80,7 +78,7 @@ void Weapons::loadDefaults()
 {
 	for (size_t i = 100, size = Item::items.size(); i < size; ++i) {
 		const ItemType& it = Item::items.getItemType(i);
-		if (it.id == 0 || weapons.find(i) != weapons.end()) {
+		if (it.id == 0 || (i < weapons.size() && weapons[i])) {
 			continue;
 		}
 
@@ -90,7 +88,7 @@ void Weapons::loadDefaults()
 			case WEAPON_CLUB: {
 				WeaponMelee* weapon = new WeaponMelee(&scriptInterface);
 				weapon->configureWeapon(it);
-				weapons[i] = weapon;
+				addWeapon(i, weapon, true);
 				break;
 			}
 
@@ -102,7 +100,7 @@ void Weapons::loadDefaults()
 
 				WeaponDistance* weapon = new WeaponDistance(&scriptInterface);
 				weapon->configureWeapon(it);
-				weapons[i] = weapon;
+				addWeapon(i, weapon, true);
 				break;
 			}
 
@@ -128,18 +126,30 @@ bool Weapons::registerEvent(Event_ptr event, const pugi::xml_node&)
 {
 	Weapon* weapon = static_cast<Weapon*>(event.release()); //event is guaranteed to be a Weapon
 
-	auto result = weapons.emplace(weapon->getID(), weapon);
-	if (!result.second) {
+	bool result = addWeapon(weapon->getID(), weapon, false);
+	if (!result) {
 		std::cout << "[Warning - Weapons::registerEvent] Duplicate registered item with id: " << weapon->getID() << std::endl;
 	}
-	return result.second;
+	return result;
 }
 
 bool Weapons::registerLuaEvent(Weapon* event)
 {
 	Weapon_ptr weapon{ event };
-	weapons[weapon->getID()] = weapon.release();
+	addWeapon(weapon->getID(), weapon.release(), true);
+
+	return true;
+}
+
+bool Weapons::addWeapon(uint16_t id, Weapon* weapon, bool replace)
+{
+	if (id >= weapons.size()) {
+		weapons.resize(id + 1, nullptr);
+	} else if (weapons[id] && !replace) {
+		return false;
+	}
 
+	weapons[id] = weapon;
 	return true;
 }
 
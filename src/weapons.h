@@ -61,7 +61,10 @@ class Weapons final : public BaseEvents
 		Event_ptr getEvent(const std::string& nodeName) override;
 		bool registerEvent(Event_ptr event, const pugi::xml_node& node) override;
 
-		std::map<uint32_t, Weapon*> weapons;
+		// indexed by item id
+		std::vector<Weapon*> weapons;
+
+		bool addWeapon(uint16_t id, Weapon* weapon, bool replace);
 
 		LuaScriptInterface scriptInterface { "Weapon Interface" };
 };